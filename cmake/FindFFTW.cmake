@@ -5,8 +5,10 @@
 #
 # It sets the following variables:
 #   FFTW_FOUND					... true if fftw is found on the system
-#   FFTW_LIBRARIES				... full path to fftw library
+#   FFTW_LIBRARIES				... full path to fftw libraries (double and, if found, single precision)
 #   FFTW_INCLUDES				... fftw include directory
+#   FFTW_SINGLE_FOUND			... true if the optional single precision library is found (part of FFTW_LIBRARIES)
+#   FFTW_THREADS_FOUND			... true if the fftw threads libraries are found (part of FFTW_LIBRARIES)
 #
 # The following variables will be checked by the function
 #   FFTW_USE_STATIC_LIBS		... if true, only static libraries are found
@@ -18,6 +20,12 @@
 if (FFTW_LIBRARIES AND FFTW_INCLUDE_DIRS)
   # in cache already
   set(FFTW_FOUND TRUE)
+  if (FFTWF_LIBRARY)
+    set(FFTW_SINGLE_FOUND TRUE)
+  endif (FFTWF_LIBRARY)
+  if (FFTW_THREADS_LIBRARY AND (FFTWF_THREADS_LIBRARY OR NOT FFTW_SINGLE_FOUND))
+    set(FFTW_THREADS_FOUND TRUE)
+  endif (FFTW_THREADS_LIBRARY AND (FFTWF_THREADS_LIBRARY OR NOT FFTW_SINGLE_FOUND))
 else (FFTW_LIBRARIES AND FFTW_INCLUDE_DIRS)
 
 if (FFTW_USE_STATIC_LIBS AND NOT MSVC)
@@ -47,22 +55,82 @@ endif (FFTW_USE_STATIC_LIBS AND NOT MSVC)
       /sw/lib
   )
 
+  # optional single precision
+  find_library(FFTWF_LIBRARY
+    NAMES
+      fftw3f
+      libfftw3f${LIBFFTW_LIB_SUFFIX}
+    PATHS
+      /usr/lib
+      /usr/local/lib
+      /opt/local/lib
+      /sw/lib
+  )
+
+  # optional multithreading support
+  find_library(FFTW_THREADS_LIBRARY
+    NAMES
+      fftw3_threads
+      libfftw3_threads${LIBFFTW_LIB_SUFFIX}
+    PATHS
+      /usr/lib
+      /usr/local/lib
+      /opt/local/lib
+      /sw/lib
+  )
+  find_library(FFTWF_THREADS_LIBRARY
+    NAMES
+      fftw3f_threads
+      libfftw3f_threads${LIBFFTW_LIB_SUFFIX}
+    PATHS
+      /usr/lib
+      /usr/local/lib
+      /opt/local/lib
+      /sw/lib
+  )
+
   set(FFTW_INCLUDE_DIRS
     ${FFTW_INCLUDE_DIR}
   )
-  set(FFTW_LIBRARIES
-    ${FFTW_LIBRARY}
-)
+  if (FFTW_LIBRARY)
+    set(FFTW_LIBRARIES
+      ${FFTW_LIBRARY}
+    )
+  endif (FFTW_LIBRARY)
+  if (FFTW_LIBRARY AND FFTWF_LIBRARY)
+    set(FFTW_SINGLE_FOUND TRUE)
+    set(FFTW_LIBRARIES
+      ${FFTW_LIBRARIES}
+      ${FFTWF_LIBRARY}
+    )
+  endif (FFTW_LIBRARY AND FFTWF_LIBRARY)
 
   if (FFTW_INCLUDE_DIRS AND FFTW_LIBRARIES)
      set(FFTW_FOUND TRUE)
   endif (FFTW_INCLUDE_DIRS AND FFTW_LIBRARIES)
 
+  # the threads libraries must precede the fftw libraries, single precision needs both
+  if (FFTW_FOUND AND FFTW_THREADS_LIBRARY AND (FFTWF_THREADS_LIBRARY OR NOT FFTW_SINGLE_FOUND))
+    set(FFTW_THREADS_FOUND TRUE)
+    if (FFTW_SINGLE_FOUND)
+      set(FFTW_LIBRARIES
+        ${FFTWF_THREADS_LIBRARY}
+        ${FFTW_LIBRARIES}
+      )
+    endif (FFTW_SINGLE_FOUND)
+    set(FFTW_LIBRARIES
+      ${FFTW_THREADS_LIBRARY}
+      ${FFTW_LIBRARIES}
+    )
+  endif (FFTW_FOUND AND FFTW_THREADS_LIBRARY AND (FFTWF_THREADS_LIBRARY OR NOT FFTW_SINGLE_FOUND))
+
   if (FFTW_FOUND)
     if (NOT FFTW_FIND_QUIETLY)
       message(STATUS "Found libfftw3:")
 	  message(STATUS " - Includes: ${FFTW_INCLUDE_DIRS}")
 	  message(STATUS " - Libraries: ${FFTW_LIBRARIES}")
+	  message(STATUS " - Single precision: ${FFTW_SINGLE_FOUND}")
+	  message(STATUS " - Threads: ${FFTW_THREADS_FOUND}")
     endif (NOT FFTW_FIND_QUIETLY)
   else (FFTW_FOUND)
     if (FFTW_FIND_REQUIRED)
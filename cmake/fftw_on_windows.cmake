@@ -39,6 +39,8 @@ CheckExitCodeAndExitIfError("tar")
 
 get_filename_component(_vs_bin_path "${CMAKE_LINKER}" DIRECTORY)
 
+# double and single precision libraries
+foreach(FFTW_LIB libfftw3-3 libfftw3f-3)
 if(CMAKE_HOST_UNIX AND WIN32)
     set(DLLTOOL "i686-w64-mingw32-dlltool")
     execute_process (
@@ -48,7 +50,7 @@ if(CMAKE_HOST_UNIX AND WIN32)
     message(STATUS "Found dlltool: ${isExists}")
     if("${isExists}" MATCHES "${DLLTOOL}")
         execute_process(
-	    COMMAND ${DLLTOOL} ${LIBEXE_64} -d ${CMAKE_BINARY_DIR}/fftw/libfftw3-3.def -l ${CMAKE_BINARY_DIR}/fftw/libfftw3-3.lib
+	    COMMAND ${DLLTOOL} ${LIBEXE_64} -d ${CMAKE_BINARY_DIR}/fftw/${FFTW_LIB}.def -l ${CMAKE_BINARY_DIR}/fftw/${FFTW_LIB}.lib
 	    WORKING_DIRECTORY "${CMAKE_BINARY_DIR}/fftw"
 	    OUTPUT_VARIABLE OutVar
 	    ERROR_VARIABLE ErrVar
@@ -59,16 +61,19 @@ if(CMAKE_HOST_UNIX AND WIN32)
     endif()
 else()
     execute_process(
-	COMMAND "${_vs_bin_path}/lib.exe" ${LIBEXE_64} /def:${CMAKE_BINARY_DIR}/fftw/libfftw3-3.def /out:${CMAKE_BINARY_DIR}/fftw/libfftw3-3.lib
+	COMMAND "${_vs_bin_path}/lib.exe" ${LIBEXE_64} /def:${CMAKE_BINARY_DIR}/fftw/${FFTW_LIB}.def /out:${CMAKE_BINARY_DIR}/fftw/${FFTW_LIB}.lib
 	WORKING_DIRECTORY "${CMAKE_BINARY_DIR}/fftw"
 	OUTPUT_VARIABLE OutVar
 	ERROR_VARIABLE ErrVar
 	RESULT_VARIABLE ExitCode)
     CheckExitCodeAndExitIfError("lib.exe: ${OutVar} ${ErrVar}")
 endif()
+endforeach()
 
 
-target_link_libraries(${PROJECT_NAME} "${CMAKE_BINARY_DIR}/fftw/libfftw3-3.lib")
+target_link_libraries(${PROJECT_NAME} "${CMAKE_BINARY_DIR}/fftw/libfftw3-3.lib" "${CMAKE_BINARY_DIR}/fftw/libfftw3f-3.lib")
+# the windows dlls contain the multithreading support
+target_compile_definitions(${PROJECT_NAME} PRIVATE HAVE_FFTW_SINGLE HAVE_FFTW_THREADS)
 target_include_directories(${PROJECT_NAME} PRIVATE "${CMAKE_BINARY_DIR}/fftw")
 
 file(COPY "${CMAKE_BINARY_DIR}/fftw/fftw3.h" DESTINATION "${CMAKE_SOURCE_DIR}/src")
@@ -76,6 +81,7 @@ file(COPY "${CMAKE_BINARY_DIR}/fftw/fftw3.h" DESTINATION "${CMAKE_SOURCE_DIR}/sr
 add_custom_command(TARGET ${PROJECT_NAME}
         POST_BUILD
         COMMAND ${CMAKE_COMMAND} -E copy_if_different "${CMAKE_BINARY_DIR}/fftw/libfftw3-3.dll" $<TARGET_FILE_DIR:${PROJECT_NAME}>
+        COMMAND ${CMAKE_COMMAND} -E copy_if_different "${CMAKE_BINARY_DIR}/fftw/libfftw3f-3.dll" $<TARGET_FILE_DIR:${PROJECT_NAME}>
         COMMENT "Copy fftw3 dlls for ${PROJECT_NAME}"
 )
 
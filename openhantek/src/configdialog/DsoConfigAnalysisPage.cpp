@@ -76,9 +76,51 @@ DsoConfigAnalysisPage::DsoConfigAnalysisPage( DsoSettings *settings, QWidget *pa
     powerGroup = new QGroupBox( tr( "Power" ) );
     powerGroup->setLayout( powerLayout );
 
+    rollWindowLabel = new QLabel( tr( "Measure over the last samples in roll mode<br/>(0 = displayed samples)" ) );
+    rollWindowSpinBox = new QDoubleSpinBox();
+    rollWindowSpinBox->setDecimals( 1 );
+    rollWindowSpinBox->setMinimum( 0 ); // 0 = off
+    rollWindowSpinBox->setMaximum( 1000 );
+    rollWindowSpinBox->setValue( settings->scope.analysis.rollWindow );
+    rollWindowUnitLabel = new QLabel( tr( "s" ) );
+    rollWindowLayout = new QHBoxLayout();
+    rollWindowLayout->addWidget( rollWindowSpinBox );
+    rollWindowLayout->addWidget( rollWindowUnitLabel );
+    rollLayout = new QGridLayout();
+    rollLayout->addWidget( rollWindowLabel, 0, 0 );
+    rollLayout->addLayout( rollWindowLayout, 0, 1 );
+
+    rollGroup = new QGroupBox( tr( "Roll mode" ) );
+    rollGroup->setLayout( rollLayout );
+
+    sensorLabel = new QLabel( tr( "Convert the input voltage x into the value of a sensor:<br/>"
+                                  "&bull; poly: c0 c1 c2 ... &rarr; c0 + c1&middot;x + c2&middot;x&sup2; + ...<br/>"
+                                  "&bull; table: x0 y0 x1 y1 ... &rarr; linear interpolation<br/>"
+                                  "Leave empty to display the voltage." ) );
+    sensorLayout = new QGridLayout();
+    sensorLayout->addWidget( sensorLabel, 0, 0, 1, 3 );
+    for ( ChannelID channel = 0; channel < settings->deviceSpecification->channels; ++channel ) {
+        const TransferFunction &sensor = settings->scope.voltage[ channel ].sensor;
+        QLineEdit *lineEdit = new QLineEdit( sensor.definition() );
+        lineEdit->setPlaceholderText( tr( "e.g. poly: 0 100" ) );
+        QLineEdit *unitLineEdit = new QLineEdit( sensor.unitDefinition() );
+        unitLineEdit->setPlaceholderText( tr( "Unit" ) );
+        unitLineEdit->setMaximumWidth( 60 );
+        sensorLineEdit.push_back( lineEdit );
+        sensorUnitLineEdit.push_back( unitLineEdit );
+        sensorLayout->addWidget( new QLabel( settings->scope.voltage[ channel ].name ), int( channel ) + 1, 0 );
+        sensorLayout->addWidget( lineEdit, int( channel ) + 1, 1 );
+        sensorLayout->addWidget( unitLineEdit, int( channel ) + 1, 2 );
+    }
+
+    sensorGroup = new QGroupBox( tr( "Sensor" ) );
+    sensorGroup->setLayout( sensorLayout );
+
     mainLayout = new QVBoxLayout();
     mainLayout->addWidget( spectrumGroup );
     mainLayout->addWidget( powerGroup );
+    mainLayout->addWidget( rollGroup );
+    mainLayout->addWidget( sensorGroup );
     mainLayout->addStretch( 1 );
 
     setLayout( mainLayout );
@@ -92,4 +134,14 @@ void DsoConfigAnalysisPage::saveSettings() {
     settings->post.spectrumLimit = minimumMagnitudeSpinBox->value();
     settings->scope.analysis.dummyLoad = unsigned( dummyLoadSpinBox->value() );
     settings->scope.analysis.calculateTHD = thdCheckBox->isChecked();
+    settings->scope.analysis.rollWindow = rollWindowSpinBox->value();
+    for ( ChannelID channel = 0; channel < sensorLineEdit.size(); ++channel ) {
+        TransferFunction sensor( sensorLineEdit[ channel ]->text(), sensorUnitLineEdit[ channel ]->text() );
+        if ( sensor.isValid() ) {
+            settings->scope.voltage[ channel ].sensor = sensor;
+            sensorLineEdit[ channel ]->setStyleSheet( QString() );
+        } else { // keep the old function and mark the wrong input
+            sensorLineEdit[ channel ]->setStyleSheet( "color: red" );
+        }
+    }
 }
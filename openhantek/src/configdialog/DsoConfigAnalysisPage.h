@@ -11,6 +11,7 @@
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QLineEdit>
 #include <QSpinBox>
 #include <QVBoxLayout>
 
@@ -55,4 +56,17 @@ class DsoConfigAnalysisPage : public QWidget {
     QLabel *thdLabel;
     QCheckBox *thdCheckBox;
     QHBoxLayout *thdLayout;
+
+    QGroupBox *rollGroup;
+    QGridLayout *rollLayout;
+    QLabel *rollWindowLabel;
+    QDoubleSpinBox *rollWindowSpinBox;
+    QLabel *rollWindowUnitLabel;
+    QHBoxLayout *rollWindowLayout;
+
+    QGroupBox *sensorGroup;
+    QGridLayout *sensorLayout;
+    QLabel *sensorLabel;
+    std::vector< QLineEdit * > sensorLineEdit;     ///< transfer function of each channel
+    std::vector< QLineEdit * > sensorUnitLineEdit; ///< unit of each channel
 };
@@ -22,11 +22,34 @@ DsoConfigScopePage::DsoConfigScopePage( DsoSettings *settings, QWidget *parent )
     acquireIntervalSiSpinBox->setMaximum( 100e-3 ); // up to 100 ms holdOff
     acquireIntervalSiSpinBox->setValue( settings->scope.horizontal.acquireInterval );
 
+    samplerateFallbackCheckBox = new QCheckBox( tr( "Switch to a lower samplerate after repeated USB transfer errors" ) );
+    samplerateFallbackCheckBox->setChecked( settings->scope.horizontal.samplerateFallback );
+
+    continuousStreamCheckBox =
+        new QCheckBox( tr( "Continuous data stream up to 1 MB/s (discard the settling samples only after a restart)" ) );
+    continuousStreamCheckBox->setChecked( settings->scope.horizontal.continuousStream );
+
+    dualTimebaseCheckBox =
+        new QCheckBox( tr( "Dual timebase (capture the zoomed part alternately with a higher samplerate)" ) );
+    dualTimebaseCheckBox->setChecked( settings->scope.horizontal.dualTimebase );
+
+    roiCheckBox = new QCheckBox( tr( "Process only the displayed part of the record (region of interest)" ) );
+    roiCheckBox->setChecked( settings->scope.horizontal.roi );
+    roiSpectrumCheckBox = new QCheckBox( tr( "Region of interest also for the spectrum" ) );
+    roiSpectrumCheckBox->setChecked( settings->scope.horizontal.roiSpectrum );
+    roiSpectrumCheckBox->setEnabled( settings->scope.horizontal.roi );
+    connect( roiCheckBox, &QAbstractButton::toggled, roiSpectrumCheckBox, &QWidget::setEnabled );
+
     horizontalLayout = new QGridLayout();
     horizontalLayout->addWidget( maxTimebaseLabel, 0, 0 );
     horizontalLayout->addWidget( maxTimebaseSiSpinBox, 0, 1 );
     horizontalLayout->addWidget( acquireIntervalLabel, 1, 0 );
     horizontalLayout->addWidget( acquireIntervalSiSpinBox, 1, 1 );
+    horizontalLayout->addWidget( samplerateFallbackCheckBox, 2, 0, 1, 2 );
+    horizontalLayout->addWidget( continuousStreamCheckBox, 3, 0, 1, 2 );
+    horizontalLayout->addWidget( dualTimebaseCheckBox, 4, 0, 1, 2 );
+    horizontalLayout->addWidget( roiCheckBox, 5, 0, 1, 2 );
+    horizontalLayout->addWidget( roiSpectrumCheckBox, 6, 0, 1, 2 );
     horizontalGroup = new QGroupBox( tr( "Horizontal" ) );
     horizontalGroup->setLayout( horizontalLayout );
 
@@ -44,6 +67,21 @@ DsoConfigScopePage::DsoConfigScopePage( DsoSettings *settings, QWidget *parent )
     interpolationComboBox = new QComboBox();
     interpolationComboBox->addItems( interpolationStrings );
     interpolationComboBox->setCurrentIndex( settings->view.interpolation );
+    traceWidthLabel = new QLabel( tr( "Trace width (pixel)" ) );
+    traceWidthSpinBox = new QDoubleSpinBox();
+    traceWidthSpinBox->setDecimals( 1 );
+    traceWidthSpinBox->setSingleStep( 0.5 );
+    traceWidthSpinBox->setMinimum( 0.5 );
+    traceWidthSpinBox->setMaximum( 5.0 );
+    traceWidthSpinBox->setValue( settings->view.traceWidth );
+    spectrumPersistenceLabel = new QLabel( tr( "Spectrum persistence (s)" ) );
+    spectrumPersistenceSpinBox = new QDoubleSpinBox();
+    spectrumPersistenceSpinBox->setDecimals( 1 );
+    spectrumPersistenceSpinBox->setSingleStep( 0.5 );
+    spectrumPersistenceSpinBox->setMinimum( 0.0 );
+    spectrumPersistenceSpinBox->setMaximum( 60.0 );
+    spectrumPersistenceSpinBox->setSpecialValueText( tr( "Off" ) );
+    spectrumPersistenceSpinBox->setValue( settings->view.spectrumPersistence );
 
     graphLayout = new QGridLayout();
     graphLayout->addWidget( fontSizeLabel, 1, 0 );
@@ -52,6 +90,10 @@ DsoConfigScopePage::DsoConfigScopePage( DsoSettings *settings, QWidget *parent )
     graphLayout->addWidget( digitalPhosphorDepthSpinBox, 2, 1 );
     graphLayout->addWidget( interpolationLabel, 3, 0 );
     graphLayout->addWidget( interpolationComboBox, 3, 1 );
+    graphLayout->addWidget( traceWidthLabel, 4, 0 );
+    graphLayout->addWidget( traceWidthSpinBox, 4, 1 );
+    graphLayout->addWidget( spectrumPersistenceLabel, 5, 0 );
+    graphLayout->addWidget( spectrumPersistenceSpinBox, 5, 1 );
 
     graphGroup = new QGroupBox( tr( "Graph" ) );
     graphGroup->setLayout( graphLayout );
@@ -119,8 +161,15 @@ void DsoConfigScopePage::saveSettings() {
     settings->scope.hasACmodification = hasACmodificationCheckBox->isChecked();
     settings->scope.horizontal.maxTimebase = maxTimebaseSiSpinBox->value();
     settings->scope.horizontal.acquireInterval = acquireIntervalSiSpinBox->value();
+    settings->scope.horizontal.samplerateFallback = samplerateFallbackCheckBox->isChecked();
+    settings->scope.horizontal.continuousStream = continuousStreamCheckBox->isChecked();
+    settings->scope.horizontal.dualTimebase = dualTimebaseCheckBox->isChecked();
+    settings->scope.horizontal.roi = roiCheckBox->isChecked();
+    settings->scope.horizontal.roiSpectrum = roiSpectrumCheckBox->isChecked();
     settings->view.interpolation = Dso::InterpolationMode( interpolationComboBox->currentIndex() );
     settings->view.digitalPhosphorDepth = unsigned( digitalPhosphorDepthSpinBox->value() );
+    settings->view.traceWidth = traceWidthSpinBox->value();
+    settings->view.spectrumPersistence = spectrumPersistenceSpinBox->value();
     settings->view.fontSize = fontSizeSpinBox->value();
     settings->view.cursorGridPosition = Qt::ToolBarArea( cursorsComboBox->currentData().toUInt() );
     settings->alwaysSave = saveOnExitCheckBox->isChecked();
@@ -39,6 +39,11 @@ class DsoConfigScopePage : public QWidget {
     SiSpinBox *maxTimebaseSiSpinBox;
     QLabel *acquireIntervalLabel;
     SiSpinBox *acquireIntervalSiSpinBox;
+    QCheckBox *samplerateFallbackCheckBox;
+    QCheckBox *continuousStreamCheckBox;
+    QCheckBox *dualTimebaseCheckBox;
+    QCheckBox *roiCheckBox;
+    QCheckBox *roiSpectrumCheckBox;
 
     QGroupBox *graphGroup;
     QGridLayout *graphLayout;
@@ -48,6 +53,10 @@ class DsoConfigScopePage : public QWidget {
     QSpinBox *digitalPhosphorDepthSpinBox;
     QLabel *interpolationLabel;
     QComboBox *interpolationComboBox;
+    QLabel *traceWidthLabel;
+    QDoubleSpinBox *traceWidthSpinBox;
+    QLabel *spectrumPersistenceLabel;
+    QDoubleSpinBox *spectrumPersistenceSpinBox;
 
     QGroupBox *cursorsGroup;
     QGridLayout *cursorsLayout;
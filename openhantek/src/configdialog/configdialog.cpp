@@ -116,6 +116,7 @@ void DsoConfigDialog::apply() {
     this->scopePage->saveSettings();
     this->analysisPage->saveSettings();
     this->colorsPage->saveSettings();
+    emit settingsApplied();
 }
 
 
@@ -30,6 +30,9 @@ class DsoConfigDialog : public QDialog {
 
     void changePage( QListWidgetItem *current, QListWidgetItem *previous );
 
+  signals:
+    void settingsApplied(); ///< The settings were saved, e.g. to update the device control
+
   private:
     void createIcons();
 
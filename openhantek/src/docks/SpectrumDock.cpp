@@ -79,6 +79,29 @@ SpectrumDock::SpectrumDock( DsoSettingsScope *scope, QWidget *parent ) : QDockWi
     connect( frequencybaseSiSpinBox, SELECT< double >::OVERLOAD_OF( &QDoubleSpinBox::valueChanged ), this,
              &SpectrumDock::frequencybaseSelected );
 
+    // Spectrum acquisition, the samplerate and record length follow span and RBW if no voltage channel is shown
+    acquisitionCheckBox = new QCheckBox( tr( "Span / RBW acquisition" ) );
+    acquisitionCheckBox->setToolTip( tr( "Select samplerate and record length for span and RBW, "
+                                         "active if only spectrum channels are shown" ) );
+    spanLabel = new QLabel( tr( "Span" ) );
+    spanSiSpinBox = new SiSpinBox( UNIT_HERTZ );
+    spanSiSpinBox->setMinimum( 10 );
+    spanSiSpinBox->setMaximum( 30e6 );
+    rbwLabel = new QLabel( tr( "RBW" ) );
+    rbwSiSpinBox = new SiSpinBox( UNIT_HERTZ );
+    rbwSiSpinBox->setMinimum( 0.1 );
+    rbwSiSpinBox->setMaximum( 100e3 );
+    dockLayout->addWidget( acquisitionCheckBox, int( channel ) + 1, 0, 1, 2 );
+    dockLayout->addWidget( spanLabel, int( channel ) + 2, 0 );
+    dockLayout->addWidget( spanSiSpinBox, int( channel ) + 2, 1 );
+    dockLayout->addWidget( rbwLabel, int( channel ) + 3, 0 );
+    dockLayout->addWidget( rbwSiSpinBox, int( channel ) + 3, 1 );
+    connect( acquisitionCheckBox, &QCheckBox::toggled, this, &SpectrumDock::spectrumAcquisitionSelected );
+    connect( spanSiSpinBox, SELECT< double >::OVERLOAD_OF( &QDoubleSpinBox::valueChanged ), this,
+             &SpectrumDock::spectrumAcquisitionSelected );
+    connect( rbwSiSpinBox, SELECT< double >::OVERLOAD_OF( &QDoubleSpinBox::valueChanged ), this,
+             &SpectrumDock::spectrumAcquisitionSelected );
+
     // Load settings into GUI
     this->loadSettings( scope );
 
@@ -95,6 +118,12 @@ void SpectrumDock::loadSettings( DsoSettingsScope *scope ) {
         channelBlocks[ channel ].usedCheckBox->setEnabled( scope->horizontal.format == Dso::GraphFormat::TY );
     }
     setFrequencybase( scope->horizontal.frequencybase );
+    QSignalBlocker acquisitionBlocker( acquisitionCheckBox );
+    QSignalBlocker spanBlocker( spanSiSpinBox );
+    QSignalBlocker rbwBlocker( rbwSiSpinBox );
+    acquisitionCheckBox->setChecked( scope->horizontal.spectrumAcquisition );
+    spanSiSpinBox->setValue( scope->horizontal.span );
+    rbwSiSpinBox->setValue( scope->horizontal.rbw );
 }
 
 
@@ -165,3 +194,16 @@ void SpectrumDock::frequencybaseSelected( double frequencybase ) {
     scope->horizontal.frequencybase = frequencybase;
     emit frequencybaseChanged( frequencybase );
 }
+
+
+/// \brief Called when the spectrum acquisition checkbox, the span or the RBW spinbox change their value.
+void SpectrumDock::spectrumAcquisitionSelected() {
+    scope->horizontal.spectrumAcquisition = acquisitionCheckBox->isChecked();
+    scope->horizontal.span = spanSiSpinBox->value();
+    scope->horizontal.rbw = rbwSiSpinBox->value();
+    emit spectrumAcquisitionChanged( scope->horizontal.spectrumAcquisition, scope->horizontal.span, scope->horizontal.rbw );
+    if ( scope->horizontal.spectrumAcquisition ) { // show the span on the screen
+        setFrequencybase( scope->horizontal.span / DIVS_TIME );
+        frequencybaseSelected( frequencybaseSiSpinBox->value() );
+    }
+}
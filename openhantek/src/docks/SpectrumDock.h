@@ -57,6 +57,7 @@ class SpectrumDock : public QDockWidget {
 
   private slots:
     void frequencybaseSelected( double frequencybase );
+    void spectrumAcquisitionSelected();
 
   protected:
     void closeEvent( QCloseEvent *event );
@@ -77,9 +78,15 @@ class SpectrumDock : public QDockWidget {
     QStringList magnitudeStrings;         ///< String representations for the magnitude steps
     QLabel *frequencybaseLabel;           ///< The label for the frequencybase spinbox
     SiSpinBox *frequencybaseSiSpinBox;    ///< Selects the frequencybase for spectrum graphs
+    QCheckBox *acquisitionCheckBox;       ///< Select samplerate and record length from span and RBW
+    QLabel *spanLabel;                    ///< The label for the span spinbox
+    SiSpinBox *spanSiSpinBox;             ///< Selects the frequency span of the spectrum acquisition
+    QLabel *rbwLabel;                     ///< The label for the RBW spinbox
+    SiSpinBox *rbwSiSpinBox;              ///< Selects the resolution bandwidth of the spectrum acquisition
 
   signals:
-    void magnitudeChanged( ChannelID channel, double magnitude ); ///< A magnitude has been selected
-    void usedChanged( ChannelID channel, bool used );             ///< A spectrum has been enabled/disabled
-    void frequencybaseChanged( double frequencybase );            ///< The frequencybase has been changed
+    void magnitudeChanged( ChannelID channel, double magnitude );             ///< A magnitude has been selected
+    void usedChanged( ChannelID channel, bool used );                         ///< A spectrum has been enabled/disabled
+    void frequencybaseChanged( double frequencybase );                        ///< The frequencybase has been changed
+    void spectrumAcquisitionChanged( bool enabled, double span, double rbw ); ///< Span / RBW acquisition changed
 };
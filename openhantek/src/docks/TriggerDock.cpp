@@ -5,6 +5,7 @@
 #include <QComboBox>
 #include <QDockWidget>
 #include <QLabel>
+#include <QLineEdit>
 #include <QSignalBlocker>
 
 #include <cmath>
@@ -44,6 +45,19 @@ TriggerDock::TriggerDock( DsoSettingsScope *scope, const Dso::ControlSpecificati
     smoothComboBox = new QComboBox();
     smoothComboBox->addItems( smoothStandardStrings );
 
+    serialLabel = new QLabel( tr( "Serial" ) );
+    serialComboBox = new QComboBox();
+    for ( Dso::SerialProtocol protocol : Dso::SerialProtocolEnum )
+        serialComboBox->addItem( Dso::serialProtocolString( protocol ) );
+    baudComboBox = new QComboBox();
+    for ( unsigned baudrate : {1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600} )
+        baudComboBox->addItem( tr( "%1 Bd" ).arg( baudrate ), baudrate );
+    patternEdit = new QLineEdit();
+    patternEdit->setPlaceholderText( tr( "e.g. S @50 0x4? 'A'" ) );
+    patternEdit->setToolTip( tr( "Byte sequence separated by space: 41, 0x4?, ??, 0b0100xxxx, 'A',\n"
+                                 "@50 (I2C address, read or write), S (I2C start, begin of SPI frame)\n"
+                                 "UART: trigger source channel, SPI and I2C: CH1 = clock, CH2 = data" ) );
+
     dockLayout = new QGridLayout();
     dockLayout->setColumnMinimumWidth( 0, 50 );
     dockLayout->setColumnStretch( 1, 1 ); // stretch 2nd (middle) column 1x
@@ -56,6 +70,10 @@ TriggerDock::TriggerDock( DsoSettingsScope *scope, const Dso::ControlSpecificati
     dockLayout->addWidget( slopeLabel, 2, 0 );
     dockLayout->addWidget( slopeComboBox, 2, 1 );
     dockLayout->addWidget( smoothComboBox, 2, 2 );
+    dockLayout->addWidget( serialLabel, 3, 0 );
+    dockLayout->addWidget( serialComboBox, 3, 1 );
+    dockLayout->addWidget( baudComboBox, 3, 2 );
+    dockLayout->addWidget( patternEdit, 4, 1, 1, 2 ); // fill 1 row, 2 col
 
     dockWidget = new QWidget();
     SetupDockWidget( this, dockWidget, dockLayout );
@@ -80,6 +98,20 @@ TriggerDock::TriggerDock( DsoSettingsScope *scope, const Dso::ControlSpecificati
         this->scope->trigger.smooth = index;
         emit smoothChanged( index );
     } );
+    connect( serialComboBox, static_cast< void ( QComboBox::* )( int ) >( &QComboBox::currentIndexChanged ), [this]( int index ) {
+        this->scope->trigger.serialProtocol = Dso::SerialProtocol( index );
+        emitSerialChanged();
+    } );
+    connect( baudComboBox, static_cast< void ( QComboBox::* )( int ) >( &QComboBox::currentIndexChanged ), [this]( int index ) {
+        this->scope->trigger.baudrate = baudComboBox->itemData( index ).toUInt();
+        emitSerialChanged();
+    } );
+    connect( patternEdit, &QLineEdit::editingFinished, [this]() {
+        if ( patternEdit->text() == this->scope->trigger.serialPattern )
+            return;
+        this->scope->trigger.serialPattern = patternEdit->text();
+        emitSerialChanged();
+    } );
 }
 
 void TriggerDock::loadSettings( DsoSettingsScope *scope ) {
@@ -88,6 +120,7 @@ void TriggerDock::loadSettings( DsoSettingsScope *scope ) {
     setSlope( scope->trigger.slope );
     setSource( scope->trigger.source );
     setSmooth( scope->trigger.smooth );
+    setSerial( scope->trigger.serialProtocol, scope->trigger.serialPattern, scope->trigger.baudrate );
 }
 
 /// \brief Don't close the dock, just hide it
@@ -123,3 +156,27 @@ void TriggerDock::setSmooth( int smooth ) {
     QSignalBlocker blocker( smoothComboBox );
     smoothComboBox->setCurrentIndex( int( smooth ) );
 }
+
+void TriggerDock::setSerial( Dso::SerialProtocol protocol, const QString &pattern, unsigned baudrate ) {
+    QSignalBlocker serialBlocker( serialComboBox );
+    QSignalBlocker baudBlocker( baudComboBox );
+    QSignalBlocker patternBlocker( patternEdit );
+    serialComboBox->setCurrentIndex( int( protocol ) );
+    int index = baudComboBox->findData( baudrate );
+    if ( index < 0 ) { // non standard rate from config file
+        baudComboBox->addItem( tr( "%1 Bd" ).arg( baudrate ), baudrate );
+        index = baudComboBox->count() - 1;
+    }
+    baudComboBox->setCurrentIndex( index );
+    patternEdit->setText( pattern );
+    // the slope is not used by the serial trigger, the baudrate only by UART
+    slopeComboBox->setEnabled( protocol == Dso::SerialProtocol::OFF );
+    smoothComboBox->setEnabled( protocol == Dso::SerialProtocol::OFF );
+    baudComboBox->setVisible( protocol == Dso::SerialProtocol::UART );
+    patternEdit->setEnabled( protocol != Dso::SerialProtocol::OFF );
+}
+
+void TriggerDock::emitSerialChanged() {
+    setSerial( scope->trigger.serialProtocol, scope->trigger.serialPattern, scope->trigger.baudrate ); // update the widgets
+    emit serialChanged( scope->trigger.serialProtocol, scope->trigger.serialPattern, scope->trigger.baudrate );
+}
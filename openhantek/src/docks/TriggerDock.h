@@ -7,6 +7,7 @@
 #include <QDockWidget>
 #include <QGridLayout>
 #include <QLabel>
+#include <QLineEdit>
 
 #include "hantekdso/enums.h"
 
@@ -45,6 +46,12 @@ class TriggerDock : public QDockWidget {
     /// \param slope The trigger slope.
     void setSlope( Dso::Slope slope );
 
+    /// \brief Changes the serial trigger protocol, pattern and UART baudrate.
+    /// \param protocol The serial protocol, OFF = slope trigger.
+    /// \param pattern The byte pattern.
+    /// \param baudrate The UART bit rate.
+    void setSerial( Dso::SerialProtocol protocol, const QString &pattern, unsigned baudrate );
+
   public slots:
     /// \brief Loads settings into GUI
     /// \param scope Settings to load
@@ -62,6 +69,10 @@ class TriggerDock : public QDockWidget {
     QComboBox *sourceComboBox; ///< Select the source for triggering
     QComboBox *smoothComboBox; ///< Select the filter for triggering
     QComboBox *slopeComboBox;  ///< Select the slope that causes triggering
+    QLabel *serialLabel;       ///< The label for the serial trigger widgets
+    QComboBox *serialComboBox; ///< Select the serial protocol (or slope trigger)
+    QComboBox *baudComboBox;   ///< Select the UART baudrate
+    QLineEdit *patternEdit;    ///< The serial trigger pattern
 
     DsoSettingsScope *scope; ///< The settings provided by the parent class
     const Dso::ControlSpecification *mSpec;
@@ -69,9 +80,12 @@ class TriggerDock : public QDockWidget {
     QStringList sourceStandardStrings; ///< Strings for the standard trigger sources
     QStringList smoothStandardStrings; ///< Strings for the standard trigger filtering
 
+    void emitSerialChanged();
+
   signals:
     void modeChanged( Dso::TriggerMode ); ///< The trigger mode has been changed
     void sourceChanged( int id );         ///< The trigger source has been changed
     void smoothChanged( int smooth );     ///< The trigger smoothing has been changed
     void slopeChanged( Dso::Slope );      ///< The trigger slope has been changed
+    void serialChanged( Dso::SerialProtocol, const QString &pattern, unsigned baudrate ); ///< The serial trigger has been changed
 };
@@ -11,9 +11,17 @@
 #include "dockwindows.h"
 
 #include "dsosettings.h"
+#include "post/ppresult.h"
 #include "sispinbox.h"
 #include "utils/printutils.h"
 
+// Autorange: step down if the input voltage stays below this part of the screen range for some frames,
+// the largest gain step ratio is 2.5, i.e. the signal uses max. 75% of the range after the step (hysteresis)
+static const double AUTORANGE_LOW = 0.3;
+static const unsigned AUTORANGE_FRAMES = 5;
+// ignore the frames that were (maybe) captured with the previous gain
+static const unsigned AUTORANGE_HOLDOFF = 2;
+
 
 template < typename... Args > struct SELECT {
     template < typename C, typename R > static constexpr auto OVERLOAD_OF( R ( C::*pmf )( Args... ) ) -> decltype( pmf ) {
@@ -57,6 +65,10 @@ VoltageDock::VoltageDock( DsoSettingsScope *scope, const Dso::ControlSpecificati
         b.attnSpinBox->setMinimum( ATTENUATION_MIN );
         b.attnSpinBox->setMaximum( ATTENUATION_MAX );
         b.attnSpinBox->setPrefix( tr( "x" ) );
+        if ( channel < spec->channels ) {
+            b.autoCheckBox = new QCheckBox( tr( "Auto" ) );
+            b.autoCheckBox->setToolTip( tr( "Select the gain automatically according to the signal level" ) );
+        }
 
         channelBlocks.push_back( std::move( b ) );
 
@@ -70,7 +82,12 @@ VoltageDock::VoltageDock( DsoSettingsScope *scope, const Dso::ControlSpecificati
         dockLayout->setColumnStretch( 1, 1 ); // stretch ComboBox in 2nd (middle) column 1x
         dockLayout->setColumnStretch( 2, 2 ); // stretch ComboBox in 3rd (last) column 2x
         dockLayout->addWidget( b.usedCheckBox, row, 0 );
-        dockLayout->addWidget( b.gainComboBox, row++, 1, 1, 2 ); // fill 1 row, 2 col
+        if ( b.autoCheckBox ) {
+            dockLayout->addWidget( b.gainComboBox, row, 1, 1, 1 );
+            dockLayout->addWidget( b.autoCheckBox, row++, 2, 1, 1 );
+        } else {
+            dockLayout->addWidget( b.gainComboBox, row++, 1, 1, 2 ); // fill 1 row, 2 col
+        }
         dockLayout->addWidget( b.invertCheckBox, row, 0 );
         dockLayout->addWidget( b.attnSpinBox, row, 1, 1, 1 );    // fill 1 row, 2 col
         dockLayout->addWidget( b.miscComboBox, row++, 2, 1, 1 ); // fill 1 row, 2 col
@@ -85,13 +102,13 @@ VoltageDock::VoltageDock( DsoSettingsScope *scope, const Dso::ControlSpecificati
 
         connect( b.gainComboBox, SELECT< int >::OVERLOAD_OF( &QComboBox::currentIndexChanged ), [this, channel]( unsigned index ) {
             this->scope->voltage[ channel ].gainStepIndex = index;
-            emit gainChanged( channel, this->scope->gain( channel ) );
+            emit gainChanged( channel, this->scope->voltageGain( channel ) );
         } );
         connect( b.attnSpinBox, SELECT< int >::OVERLOAD_OF( &QSpinBox::valueChanged ), [this, channel]( unsigned attnValue ) {
             this->scope->voltage[ channel ].probeAttn = attnValue;
             setAttn( channel, attnValue );
             emit probeAttnChanged( channel, attnValue ); // make sure to set the probe first, since this will influence the gain
-            emit gainChanged( channel, this->scope->gain( channel ) );
+            emit gainChanged( channel, this->scope->voltageGain( channel ) );
         } );
         connect( b.invertCheckBox, &QAbstractButton::toggled, [this, channel]( bool checked ) {
             this->scope->voltage[ channel ].inverted = checked;
@@ -111,6 +128,11 @@ VoltageDock::VoltageDock( DsoSettingsScope *scope, const Dso::ControlSpecificati
             this->scope->voltage[ channel ].used = checked;
             emit usedChanged( channel, checked );
         } );
+        if ( b.autoCheckBox )
+            connect( b.autoCheckBox, &QAbstractButton::toggled, [this, channel]( bool checked ) {
+                this->scope->voltage[ channel ].autoRange = checked;
+                channelBlocks[ channel ].autoRangeLowFrames = 0;
+            } );
     }
 
     // Load settings into GUI
@@ -133,6 +155,7 @@ void VoltageDock::loadSettings( DsoSettingsScope *scope, const Dso::ControlSpeci
         setUsed( channel, scope->voltage[ channel ].used );
         setAttn( channel, scope->voltage[ channel ].probeAttn );
         setInverted( channel, scope->voltage[ channel ].inverted );
+        setAutoRange( channel, scope->voltage[ channel ].autoRange );
     }
 }
 
@@ -195,3 +218,48 @@ void VoltageDock::setInverted( ChannelID channel, bool inverted ) {
     QSignalBlocker blocker( channelBlocks[ channel ].invertCheckBox );
     channelBlocks[ channel ].invertCheckBox->setChecked( inverted );
 }
+
+void VoltageDock::setAutoRange( ChannelID channel, bool autoRange ) {
+    if ( channel >= spec->channels )
+        return;
+    QSignalBlocker blocker( channelBlocks[ channel ].autoCheckBox );
+    channelBlocks[ channel ].autoCheckBox->setChecked( autoRange );
+    scope->voltage[ channel ].autoRange = autoRange;
+    channelBlocks[ channel ].autoRangeLowFrames = 0;
+}
+
+void VoltageDock::autoRange( const PPresult *result ) {
+    for ( ChannelID channel = 0; channel < spec->channels && channel < result->channelCount(); ++channel ) {
+        ChannelBlock &b = channelBlocks[ channel ];
+        if ( !scope->voltage[ channel ].used || !scope->voltage[ channel ].autoRange )
+            continue;
+        if ( result->tag == b.autoRangeTag ) // evaluate each captured frame only once
+            continue;
+        b.autoRangeTag = result->tag;
+        if ( result->tag - b.autoRangeChangeTag <= AUTORANGE_HOLDOFF )
+            continue;
+        const DataChannel *data = result->data( channel );
+        if ( data->voltage.sample.empty() )
+            continue;
+        const unsigned gainStepIndex = scope->voltage[ channel ].gainStepIndex;
+        int step = 0;
+        if ( !data->valid ) { // clipped
+            step = 1;
+            b.autoRangeLowFrames = 0;
+        } else if ( data->inputPeak >= 0 ) {
+            // compare the input voltage (ADC codes) with the input range, a sensor function may have offset and curve
+            if ( data->inputPeak < AUTORANGE_LOW * scope->voltageGain( channel ) * DIVS_VOLTAGE / 2 ) {
+                if ( ++b.autoRangeLowFrames >= AUTORANGE_FRAMES ) {
+                    step = -1;
+                    b.autoRangeLowFrames = 0;
+                }
+            } else {
+                b.autoRangeLowFrames = 0;
+            }
+        }
+        if ( ( step > 0 && gainStepIndex + 1 < scope->gainSteps.size() ) || ( step < 0 && gainStepIndex > 0 ) ) {
+            b.autoRangeChangeTag = result->tag;
+            b.gainComboBox->setCurrentIndex( int( gainStepIndex ) + step ); // -> gainChanged() -> one gain command
+        }
+    }
+}
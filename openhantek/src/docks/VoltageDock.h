@@ -17,6 +17,7 @@
 #define ATTENUATION_MAX 1000 ///< Maximum probe attenuation
 
 class SiSpinBox;
+class PPresult;
 
 /// \brief Dock window for the voltage channel settings.
 /// It contains the settings for gain and coupling for both channels and
@@ -60,6 +61,18 @@ class VoltageDock : public QDockWidget {
     /// \param used True if the channel should be inverted, false otherwise.
     void setInverted( ChannelID channel, bool inverted );
 
+    /// \brief Enable/disable the automatic gain selection of a channel.
+    /// \param channel The channel, that should be changed.
+    /// \param autoRange True if the gain should follow the signal level.
+    void setAutoRange( ChannelID channel, bool autoRange );
+
+    /// \brief Adapt the gain of the channels with enabled autorange to the signal level of the new frame.
+    /// Steps up if the channel was clipped and steps down if the input voltage (measured on the ADC codes)
+    /// stayed below `AUTORANGE_LOW` of the screen range for `AUTORANGE_FRAMES` captured frames.
+    /// Each step sends one gain command.
+    /// \param result The post processed data of the new frame.
+    void autoRange( const PPresult *result );
+
   public slots:
     /// \brief Loads settings into GUI
     /// \param scope Settings to load
@@ -73,11 +86,15 @@ class VoltageDock : public QDockWidget {
     QWidget *dockWidget;     ///< The main widget for the dock window
 
     struct ChannelBlock {
-        QCheckBox *usedCheckBox;   ///< Enable/disable a specific channel
-        QComboBox *gainComboBox;   ///< Select the vertical gain for the channels
-        QComboBox *miscComboBox;   ///< Select coupling for real and mode for math channels
-        QCheckBox *invertCheckBox; ///< Select if the channels should be displayed inverted
-        QSpinBox *attnSpinBox;     ///< Enter the attenuation probe value
+        QCheckBox *usedCheckBox;           ///< Enable/disable a specific channel
+        QComboBox *gainComboBox;           ///< Select the vertical gain for the channels
+        QComboBox *miscComboBox;           ///< Select coupling for real and mode for math channels
+        QCheckBox *invertCheckBox;         ///< Select if the channels should be displayed inverted
+        QSpinBox *attnSpinBox;             ///< Enter the attenuation probe value
+        QCheckBox *autoCheckBox = nullptr; ///< Select automatic gain (physical channels only)
+        unsigned autoRangeTag = 0;         ///< Tag of the last evaluated frame
+        unsigned autoRangeChangeTag = 0;   ///< Tag of the last frame before the last gain change
+        unsigned autoRangeLowFrames = 0;   ///< Number of consecutive frames with low signal level
     };
 
     std::vector< ChannelBlock > channelBlocks;
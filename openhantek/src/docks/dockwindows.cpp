@@ -28,6 +28,7 @@ void registerDockMetaTypes() {
     qRegisterMetaType< Dso::TriggerMode >();
     qRegisterMetaType< Dso::MathMode >();
     qRegisterMetaType< Dso::Slope >();
+    qRegisterMetaType< Dso::SerialProtocol >();
     qRegisterMetaType< Dso::Coupling >();
     qRegisterMetaType< Dso::GraphFormat >();
     qRegisterMetaType< Dso::ChannelMode >();
@@ -109,6 +109,22 @@ void DsoSettings::load() {
         scope.horizontal.samplerate = storeSettings->value( "samplerate" ).toDouble();
     if ( storeSettings->contains( "calfreq" ) )
         scope.horizontal.calfreq = storeSettings->value( "calfreq" ).toDouble();
+    if ( storeSettings->contains( "samplerateFallback" ) )
+        scope.horizontal.samplerateFallback = storeSettings->value( "samplerateFallback" ).toBool();
+    if ( storeSettings->contains( "continuousStream" ) )
+        scope.horizontal.continuousStream = storeSettings->value( "continuousStream" ).toBool();
+    if ( storeSettings->contains( "dualTimebase" ) )
+        scope.horizontal.dualTimebase = storeSettings->value( "dualTimebase" ).toBool();
+    if ( storeSettings->contains( "roi" ) )
+        scope.horizontal.roi = storeSettings->value( "roi" ).toBool();
+    if ( storeSettings->contains( "roiSpectrum" ) )
+        scope.horizontal.roiSpectrum = storeSettings->value( "roiSpectrum" ).toBool();
+    if ( storeSettings->contains( "spectrumAcquisition" ) )
+        scope.horizontal.spectrumAcquisition = storeSettings->value( "spectrumAcquisition" ).toBool();
+    if ( storeSettings->contains( "span" ) )
+        scope.horizontal.span = storeSettings->value( "span" ).toDouble();
+    if ( storeSettings->contains( "rbw" ) )
+        scope.horizontal.rbw = storeSettings->value( "rbw" ).toDouble();
     storeSettings->endGroup(); // horizontal
     // Trigger
     storeSettings->beginGroup( "trigger" );
@@ -122,6 +138,12 @@ void DsoSettings::load() {
         scope.trigger.source = storeSettings->value( "source" ).toInt();
     if ( storeSettings->contains( "smooth" ) )
         scope.trigger.smooth = storeSettings->value( "smooth" ).toInt();
+    if ( storeSettings->contains( "serialProtocol" ) )
+        scope.trigger.serialProtocol = Dso::SerialProtocol( storeSettings->value( "serialProtocol" ).toUInt() );
+    if ( storeSettings->contains( "serialPattern" ) )
+        scope.trigger.serialPattern = storeSettings->value( "serialPattern" ).toString();
+    if ( storeSettings->contains( "baudrate" ) )
+        scope.trigger.baudrate = storeSettings->value( "baudrate" ).toUInt();
     storeSettings->endGroup(); // trigger
     // Spectrum
     for ( ChannelID channel = 0; channel < scope.spectrum.size(); ++channel ) {
@@ -171,6 +193,11 @@ void DsoSettings::load() {
             scope.voltage[ channel ].trigger = storeSettings->value( "trigger" ).toDouble();
         if ( storeSettings->contains( "probeAttn" ) )
             scope.voltage[ channel ].probeAttn = storeSettings->value( "probeAttn" ).toDouble();
+        if ( storeSettings->contains( "autoRange" ) )
+            scope.voltage[ channel ].autoRange = storeSettings->value( "autoRange" ).toBool();
+        if ( storeSettings->contains( "sensor" ) && channel < deviceSpecification->channels )
+            scope.voltage[ channel ].sensor =
+                TransferFunction( storeSettings->value( "sensor" ).toString(), storeSettings->value( "sensorUnit" ).toString() );
         if ( storeSettings->contains( "used" ) )
             scope.voltage[ channel ].used = storeSettings->value( "used" ).toBool();
         else                      // no config file found, e.g. 1st run
@@ -210,6 +237,8 @@ void DsoSettings::load() {
         scope.analysis.dummyLoad = storeSettings->value( "dummyLoad" ).toUInt();
     if ( storeSettings->contains( "calculateTHD" ) )
         scope.analysis.calculateTHD = storeSettings->value( "calculateTHD" ).toBool();
+    if ( storeSettings->contains( "rollWindow" ) )
+        scope.analysis.rollWindow = storeSettings->value( "rollWindow" ).toDouble();
     storeSettings->endGroup(); // analysis
     storeSettings->endGroup(); // scope
 
@@ -259,6 +288,10 @@ void DsoSettings::load() {
         view.digitalPhosphor = storeSettings->value( "digitalPhosphor" ).toBool();
     if ( storeSettings->contains( "interpolation" ) )
         view.interpolation = Dso::InterpolationMode( storeSettings->value( "interpolation" ).toInt() );
+    if ( storeSettings->contains( "traceWidth" ) )
+        view.traceWidth = storeSettings->value( "traceWidth" ).toDouble();
+    if ( storeSettings->contains( "spectrumPersistence" ) )
+        view.spectrumPersistence = storeSettings->value( "spectrumPersistence" ).toDouble();
     if ( storeSettings->contains( "printerColorImages" ) )
         view.printerColorImages = storeSettings->value( "printerColorImages" ).toBool();
     if ( storeSettings->contains( "zoom" ) )
@@ -314,6 +347,14 @@ void DsoSettings::save() {
     storeSettings->setValue( "recordLength", scope.horizontal.recordLength );
     storeSettings->setValue( "samplerate", scope.horizontal.samplerate );
     storeSettings->setValue( "calfreq", scope.horizontal.calfreq );
+    storeSettings->setValue( "samplerateFallback", scope.horizontal.samplerateFallback );
+    storeSettings->setValue( "continuousStream", scope.horizontal.continuousStream );
+    storeSettings->setValue( "dualTimebase", scope.horizontal.dualTimebase );
+    storeSettings->setValue( "roi", scope.horizontal.roi );
+    storeSettings->setValue( "roiSpectrum", scope.horizontal.roiSpectrum );
+    storeSettings->setValue( "spectrumAcquisition", scope.horizontal.spectrumAcquisition );
+    storeSettings->setValue( "span", scope.horizontal.span );
+    storeSettings->setValue( "rbw", scope.horizontal.rbw );
     storeSettings->endGroup(); // horizontal
     // Trigger
     storeSettings->beginGroup( "trigger" );
@@ -322,6 +363,9 @@ void DsoSettings::save() {
     storeSettings->setValue( "slope", unsigned( scope.trigger.slope ) );
     storeSettings->setValue( "source", scope.trigger.source );
     storeSettings->setValue( "smooth", scope.trigger.smooth );
+    storeSettings->setValue( "serialProtocol", unsigned( scope.trigger.serialProtocol ) );
+    storeSettings->setValue( "serialPattern", scope.trigger.serialPattern );
+    storeSettings->setValue( "baudrate", scope.trigger.baudrate );
     storeSettings->endGroup(); // trigger
     // Spectrum
     for ( ChannelID channel = 0; channel < scope.spectrum.size(); ++channel ) {
@@ -352,6 +396,9 @@ void DsoSettings::save() {
         storeSettings->setValue( "trigger", scope.voltage[ channel ].trigger );
         storeSettings->setValue( "used", scope.voltage[ channel ].used );
         storeSettings->setValue( "probeAttn", scope.voltage[ channel ].probeAttn );
+        storeSettings->setValue( "autoRange", scope.voltage[ channel ].autoRange );
+        storeSettings->setValue( "sensor", scope.voltage[ channel ].sensor.definition() );
+        storeSettings->setValue( "sensorUnit", scope.voltage[ channel ].sensor.unitDefinition() );
         storeSettings->beginGroup( "cursor" );
         storeSettings->setValue( "shape", scope.voltage[ channel ].cursor.shape );
         for ( int marker = 0; marker < 2; ++marker ) {
@@ -374,6 +421,7 @@ void DsoSettings::save() {
     storeSettings->beginGroup( "analysis" );
     storeSettings->setValue( "dummyLoad", scope.analysis.dummyLoad );
     storeSettings->setValue( "calculateTHD", scope.analysis.calculateTHD );
+    storeSettings->setValue( "rollWindow", scope.analysis.rollWindow );
     storeSettings->endGroup(); // analysis
     storeSettings->endGroup(); // scope
 
@@ -409,6 +457,8 @@ void DsoSettings::save() {
     storeSettings->setValue( "histogram", scope.histogram );
     storeSettings->setValue( "digitalPhosphor", view.digitalPhosphor );
     storeSettings->setValue( "interpolation", view.interpolation );
+    storeSettings->setValue( "traceWidth", view.traceWidth );
+    storeSettings->setValue( "spectrumPersistence", view.spectrumPersistence );
     // storeSettings->setValue( "fontSize", view.fontSize );
     storeSettings->setValue( "printerColorImages", view.printerColorImages );
     storeSettings->setValue( "zoom", view.zoom );
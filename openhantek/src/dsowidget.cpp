@@ -55,6 +55,9 @@ DsoWidget::DsoWidget( DsoSettingsScope *scope, DsoSettingsView *view, const Dso:
     settingsSamplesOnScreen = new QLabel();
     settingsSamplesOnScreen->setAlignment( Qt::AlignRight );
     settingsSamplesOnScreen->setPalette( palette );
+    settingsDutyCycleLabel = new QLabel();
+    settingsDutyCycleLabel->setAlignment( Qt::AlignRight );
+    settingsDutyCycleLabel->setPalette( palette );
     settingsSamplerateLabel = new QLabel();
     settingsSamplerateLabel->setAlignment( Qt::AlignRight );
     settingsSamplerateLabel->setPalette( palette );
@@ -74,6 +77,7 @@ DsoWidget::DsoWidget( DsoSettingsScope *scope, DsoSettingsView *view, const Dso:
     settingsLayout->addWidget( swTriggerStatus );
     settingsLayout->addWidget( settingsTriggerLabel );
     settingsLayout->addWidget( settingsSamplesOnScreen, 1 );
+    settingsLayout->addWidget( settingsDutyCycleLabel, 1 );
     settingsLayout->addWidget( settingsSamplerateLabel, 1 );
     settingsLayout->addWidget( settingsTimebaseLabel, 1 );
     settingsLayout->addWidget( settingsFrequencybaseLabel, 1 );
@@ -332,6 +336,7 @@ void DsoWidget::setColors() {
     paletteNow.setColor( QPalette::Window, view->colors->background );
     paletteNow.setColor( QPalette::WindowText, view->colors->text );
     settingsSamplesOnScreen->setPalette( paletteNow );
+    settingsDutyCycleLabel->setPalette( paletteNow );
     settingsSamplerateLabel->setPalette( paletteNow );
     settingsTimebaseLabel->setPalette( paletteNow );
     settingsFrequencybaseLabel->setPalette( paletteNow );
@@ -537,7 +542,7 @@ void DsoWidget::updateMarkerDetails() {
                                         scope->voltage[ channel ].cursor.shape != DsoSettingsScopeCursor::NONE ? tr( "ON" )
                                                                                                                : tr( "OFF" ),
                                         valueToString( fabs( p1.x() - p0.x() ) * scope->horizontal.timebase, UNIT_SECONDS, 4 ),
-                                        valueToString( fabs( p1.y() - p0.y() ) * scope->gain( channel ), UNIT_VOLTS, 4 ) );
+                                        channelValueString( channel, fabs( p1.y() - p0.y() ) * scope->gain( channel ), 4 ) );
         } else {
             cursorDataGrid->updateInfo( unsigned( index ), false );
         }
@@ -627,7 +632,8 @@ void DsoWidget::updateTriggerDetails() {
     QPalette tablePalette = palette();
     tablePalette.setColor( QPalette::WindowText, view->colors->voltage[ unsigned( scope->trigger.source ) ] );
     settingsTriggerLabel->setPalette( tablePalette );
-    QString levelString = valueToString( scope->voltage[ unsigned( scope->trigger.source ) ].trigger, UNIT_VOLTS, 3 );
+    QString levelString =
+        channelValueString( unsigned( scope->trigger.source ), scope->voltage[ unsigned( scope->trigger.source ) ].trigger, 3 );
     QString pretriggerString = tr( "%L1%" ).arg( int( round( scope->trigger.offset * 100 ) ) );
     QString pre = Dso::slopeString( scope->trigger.slope ); // trigger slope
     QString post = pre;                                     // opposite trigger slope
@@ -652,6 +658,21 @@ void DsoWidget::updateTriggerDetails() {
 }
 
 
+QString DsoWidget::channelValueString( ChannelID channel, double value, int precision ) const {
+    if ( channel >= scope->voltage.size() )
+        return valueToString( value, UNIT_VOLTS, precision );
+    if ( channel == spec->channels ) { // math channel: phase and frequency demodulation show rad and Hz
+        const Dso::MathMode mode = Dso::getMathMode( scope->voltage[ channel ] );
+        const QString unit = Dso::mathModeUnit( mode );
+        if ( !unit.isEmpty() )
+            return valueToString( value * Dso::mathModeScale( mode ), unit, precision );
+    }
+    if ( scope->voltage[ channel ].sensor.isIdentity() )
+        return valueToString( value, UNIT_VOLTS, precision );
+    return valueToString( value, scope->voltage[ channel ].sensor.unit(), precision );
+}
+
+
 /// \brief Update the label about the trigger settings
 void DsoWidget::updateVoltageDetails( ChannelID channel ) {
     if ( channel >= scope->voltage.size() )
@@ -660,7 +681,7 @@ void DsoWidget::updateVoltageDetails( ChannelID channel ) {
     setMeasurementVisible( channel );
 
     if ( scope->voltage[ channel ].used )
-        measurementGainLabel[ channel ]->setText( valueToString( scope->gain( channel ), UNIT_VOLTS, 3 ) + tr( "/div" ) );
+        measurementGainLabel[ channel ]->setText( channelValueString( channel, scope->gain( channel ), 3 ) + tr( "/div" ) );
     else
         measurementGainLabel[ channel ]->setText( QString() );
 }
@@ -818,8 +839,14 @@ void DsoWidget::updateZoom( bool enabled ) {
 
 /// \brief Prints analyzed data.
 void DsoWidget::showNew( std::shared_ptr< PPresult > analysedData ) {
+    // dual timebase: the overview frames go to the main scope, the detail frames to the zoomed scope
+    if ( analysedData->detail ) {
+        zoomScope->showData( analysedData );
+        return; // trigger status and measurements are taken from the overview
+    }
     mainScope->showData( analysedData );
-    zoomScope->showData( analysedData );
+    if ( !analysedData->hasDetail )
+        zoomScope->showData( analysedData );
 
     QPalette triggerLabelPalette = palette();
     if ( scope->trigger.mode == Dso::TriggerMode::ROLL ) {
@@ -832,28 +859,49 @@ void DsoWidget::showNew( std::shared_ptr< PPresult > analysedData ) {
     swTriggerStatus->setPalette( triggerLabelPalette );
     swTriggerStatus->setVisible( true );
     updateRecordLength( dotsOnScreen );
+    // how much of the signal is observed: smoothed duty cycle and the gap before this frame
+    settingsDutyCycleLabel->setText( tr( "%L1% observed" ).arg( analysedData->dutyCycle * 100, 0, 'f', 1 ) );
+    settingsDutyCycleLabel->setToolTip(
+        tr( "Dead time before this frame: %1" ).arg( valueToString( analysedData->deadTime, UNIT_SECONDS, 3 ) ) );
     pulseWidth1 = analysedData.get()->data( 0 )->pulseWidth1;
     pulseWidth2 = analysedData.get()->data( 0 )->pulseWidth2;
     updateTriggerDetails();
     for ( ChannelID channel = 0; channel < scope->voltage.size(); ++channel ) {
         if ( ( scope->voltage[ channel ].used || scope->spectrum[ channel ].used ) && analysedData.get()->data( channel ) ) {
             // Vpp Amplitude string representation (3 significant digits)
-            measurementVppLabel[ channel ]->setText( valueToString( analysedData.get()->data( channel )->vpp, UNIT_VOLTS, 3 ) +
+            measurementVppLabel[ channel ]->setText( channelValueString( channel, analysedData.get()->data( channel )->vpp, 3 ) +
                                                      tr( "pp" ) );
             // DC Amplitude string representation (3 significant digits)
-            measurementDCLabel[ channel ]->setText( valueToString( analysedData.get()->data( channel )->dc, UNIT_VOLTS, 3 ) + "=" );
+            measurementDCLabel[ channel ]->setText( channelValueString( channel, analysedData.get()->data( channel )->dc, 3 ) +
+                                                    "=" );
             // AC Amplitude string representation (3 significant digits)
-            measurementACLabel[ channel ]->setText( valueToString( analysedData.get()->data( channel )->ac, UNIT_VOLTS, 3 ) + "~" );
+            measurementACLabel[ channel ]->setText( channelValueString( channel, analysedData.get()->data( channel )->ac, 3 ) +
+                                                    "~" );
             // RMS Amplitude string representation (3 significant digits)
-            measurementRMSLabel[ channel ]->setText( valueToString( analysedData.get()->data( channel )->rms, UNIT_VOLTS, 3 ) +
+            measurementRMSLabel[ channel ]->setText( channelValueString( channel, analysedData.get()->data( channel )->rms, 3 ) +
                                                      tr( "rms" ) );
             // dB Amplitude string representation (3 significant digits)
             measurementdBLabel[ channel ]->setText( valueToString( analysedData.get()->data( channel )->dB, UNIT_DECIBEL, 3 ) );
+            measurementdBLabel[ channel ]->setToolTip( QString() );
+            const FrequencyResponse &bode = analysedData->bode;
+            if ( channel == spec->channels && bode.averages ) { // Bode mode: transfer function at the frequency of CH1
+                const QString gain = valueToString( bode.gain, UNIT_DECIBEL, 3 );
+                const QString frequency = valueToString( analysedData->data( 0 )->frequency, UNIT_HERTZ, 4 );
+                measurementdBLabel[ channel ]->setText( gain );
+                measurementdBLabel[ channel ]->setToolTip( tr( "Gain %1, phase %L2°, coherence %L3 at %4" )
+                                                               .arg( gain )
+                                                               .arg( bode.phaseShift, 0, 'f', 1 )
+                                                               .arg( bode.coherenceValue, 0, 'f', 2 )
+                                                               .arg( frequency ) );
+            }
             // Frequency string representation (3 significant digits)
             measurementFrequencyLabel[ channel ]->setText(
                 valueToString( analysedData.get()->data( channel )->frequency, UNIT_HERTZ, 4 ) );
             // RMS Amplitude string representation (3 significant digits)
-            if ( scope->analysis.dummyLoad ) { // != 0 -> show
+            bool volts = scope->voltage[ channel ].sensor.isIdentity(); // no sensor unit
+            if ( channel == spec->channels )                             // no rad or Hz of the math channel
+                volts = volts && Dso::mathModeUnit( Dso::getMathMode( scope->voltage[ channel ] ) ).isEmpty();
+            if ( scope->analysis.dummyLoad && volts ) { // != 0 -> show, only for V
                 measurementLayout->setColumnStretch( 9, 3 );
                 measurementRMSPowerLabel[ channel ]->setText(
                     valueToString( ( analysedData.get()->data( channel )->rms * analysedData.get()->data( channel )->rms ) /
@@ -54,6 +54,9 @@ class DsoWidget : public QWidget {
     void updateSpectrumDetails( ChannelID channel );
     void updateTriggerDetails();
     void updateVoltageDetails( ChannelID channel );
+    /// \brief Format a value of the channel in V or in the unit of the channel's sensor, the math channel shows
+    /// rad or Hz in the phase and frequency demodulation modes.
+    QString channelValueString( ChannelID channel, double value, int precision ) const;
 
     double mainToZoom( double position ) const;
     double zoomToMain( double position ) const;
@@ -66,6 +69,7 @@ class DsoWidget : public QWidget {
     QHBoxLayout *settingsLayout;        ///< The table for the settings info
     QLabel *settingsTriggerLabel;       ///< The trigger details
     QLabel *settingsSamplesOnScreen;    ///< The displayed dots on screen
+    QLabel *settingsDutyCycleLabel;     ///< The observed part of the signal and the dead time between the frames
     QLabel *settingsSamplerateLabel;    ///< The samplerate
     QLabel *settingsTimebaseLabel;      ///< The timebase of the main scope
     QLabel *settingsFrequencybaseLabel; ///< The frequencybase of the main scope
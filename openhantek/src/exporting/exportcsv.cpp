@@ -3,7 +3,9 @@
 #include "exportcsv.h"
 #include "dsosettings.h"
 #include "exporterregistry.h"
+#include "exportworker.h"
 #include "iconfont/QtAwesome.h"
+#include "post/postprocessingsettings.h"
 #include "post/ppresult.h"
 
 #include <QCoreApplication>
@@ -30,15 +32,40 @@ bool ExporterCSV::samples( const std::shared_ptr< PPresult > newData ) {
     return false;
 }
 
-bool ExporterCSV::save() {
+bool ExporterCSV::selectFile() {
     QFileDialog fileDialog( nullptr, tr( "Save CSV" ), QString(), tr( "Comma-Separated Values (*.csv)" ) );
     fileDialog.setFileMode( QFileDialog::AnyFile );
     fileDialog.setAcceptMode( QFileDialog::AcceptSave );
     fileDialog.setOption( QFileDialog::DontUseNativeDialog );
     if ( fileDialog.exec() != QDialog::Accepted )
         return false;
+    fileName = fileDialog.selectedFiles().first();
+    // the settings may change while the worker writes the file -> take the names, units and used flags now
+    const DsoSettingsScope &scope = registry->settings->scope;
+    voltageColumns.assign( scope.voltage.size(), QString() );
+    voltageScales.assign( scope.voltage.size(), 1.0 );
+    spectrumColumns.assign( scope.voltage.size(), QString() );
+    for ( ChannelID channel = 0; channel < scope.voltage.size(); ++channel ) {
+        QString unit = scope.voltage[ channel ].sensor.unit();
+        if ( channel + 1 == scope.voltage.size() ) { // math channel, phase and frequency demodulation: rad and Hz
+            const Dso::MathMode mode = Dso::getMathMode( scope.voltage[ channel ] );
+            if ( !Dso::mathModeUnit( mode ).isEmpty() ) {
+                unit = Dso::mathModeUnit( mode );
+                voltageScales[ channel ] = Dso::mathModeScale( mode );
+            }
+        }
+        if ( scope.voltage[ channel ].used )
+            voltageColumns[ channel ] = scope.voltage[ channel ].name + " / " + unit;
+        if ( channel < scope.spectrum.size() && scope.spectrum[ channel ].used )
+            spectrumColumns[ channel ] = scope.spectrum[ channel ].name + " / dB";
+    }
+    return true;
+}
+
 
-    QFile csvFile( fileDialog.selectedFiles().first() );
+// runs in the export worker thread, the GUI and the acquisition keep on running
+bool ExporterCSV::writeData( ExportWorker *worker ) {
+    QFile csvFile( fileName );
     if ( !csvFile.open( QIODevice::WriteOnly | QIODevice::Text ) )
         return false;
 
@@ -46,10 +73,11 @@ bool ExporterCSV::save() {
     csvStream.setRealNumberNotation( QTextStream::FixedNotation );
     csvStream.setRealNumberPrecision( 10 );
 
-    size_t chCount = registry->settings->scope.voltage.size();
+    size_t chCount = voltageColumns.size();
     std::vector< const SampleValues * > voltageData( size_t( chCount ), nullptr );
     std::vector< const SampleValues * > spectrumData( size_t( chCount ), nullptr );
     size_t maxRow = 0;
+    size_t voltageRows = 0;
     bool isSpectrumUsed = false;
     double timeInterval = 0;
     double freqInterval = 0;
@@ -59,12 +87,13 @@ bool ExporterCSV::save() {
 
     for ( ChannelID channel = 0; channel < chCount; ++channel ) {
         if ( data->data( channel ) ) {
-            if ( registry->settings->scope.voltage[ channel ].used ) {
+            if ( !voltageColumns[ channel ].isEmpty() ) {
                 voltageData[ channel ] = &( data->data( channel )->voltage );
-                maxRow = qMax( maxRow, voltageData[ channel ]->sample.size() );
+                voltageRows = qMax( voltageRows, voltageData[ channel ]->sample.size() );
+                maxRow = qMax( maxRow, voltageRows );
                 timeInterval = data->data( channel )->voltage.interval;
             }
-            if ( registry->settings->scope.spectrum[ channel ].used ) {
+            if ( !spectrumColumns[ channel ].isEmpty() ) {
                 spectrumData[ channel ] = &( data->data( channel )->spectrum );
                 maxRow = qMax( maxRow, spectrumData[ channel ]->sample.size() );
                 freqInterval = data->data( channel )->spectrum.interval;
@@ -73,30 +102,40 @@ bool ExporterCSV::save() {
         }
     }
 
-    // Start with channel names
-    csvStream << "\"t / s\"";
+    // Start with channel names, ROI mode: only the samples around the displayed window were exported
+    csvStream << "\"t / s";
+    if ( data->roiCount && voltageRows )
+        csvStream << " (ROI: samples " << data->roiFirst << " .. " << data->roiFirst + voltageRows - 1 << " of the record)";
+    csvStream << "\"";
     for ( ChannelID channel = 0; channel < chCount; ++channel ) {
         if ( voltageData[ channel ] != nullptr ) {
-            csvStream << sep << "\"" << registry->settings->scope.voltage[ channel ].name << " / V\"";
+            csvStream << sep << "\"" << voltageColumns[ channel ] << "\"";
         }
     }
     if ( isSpectrumUsed ) {
         csvStream << sep << "\"f / Hz\"";
         for ( ChannelID channel = 0; channel < chCount; ++channel ) {
             if ( spectrumData[ channel ] != nullptr ) {
-                csvStream << sep << "\"" << registry->settings->scope.spectrum[ channel ].name << " / dB\"";
+                csvStream << sep << "\"" << spectrumColumns[ channel ] << "\"";
             }
         }
     }
     csvStream << "\n";
 
     for ( unsigned int row = 0; row < maxRow; ++row ) {
-        csvStream << QLocale::system().toString( timeInterval * row );
+        if ( row % 1024 == 0 ) {
+            if ( worker->isCanceled() ) {
+                csvFile.remove();
+                return false;
+            }
+            worker->setProgress( float( row ) / maxRow );
+        }
+        csvStream << QLocale::system().toString( timeInterval * ( data->roiFirst + row ) ); // time in the whole record
         for ( ChannelID channel = 0; channel < chCount; ++channel ) {
             if ( voltageData[ channel ] != nullptr ) {
                 csvStream << sep;
                 if ( row < voltageData[ channel ]->sample.size() ) {
-                    csvStream << QLocale::system().toString( voltageData[ channel ]->sample[ row ] );
+                    csvStream << QLocale::system().toString( voltageData[ channel ]->sample[ row ] * voltageScales[ channel ] );
                 }
             }
         }
@@ -3,6 +3,8 @@
 #pragma once
 #include "exporterinterface.h"
 
+#include <vector>
+
 class ExporterCSV : public ExporterInterface {
     Q_DECLARE_TR_FUNCTIONS( LegacyExportDrawer )
 
@@ -13,9 +15,15 @@ class ExporterCSV : public ExporterInterface {
     QString name() override;
     Type type() override;
     bool samples( const std::shared_ptr< PPresult > newData ) override;
-    bool save() override;
+    bool selectFile() override;
+    bool writeData( ExportWorker *worker ) override;
     float progress() override;
 
   private:
     std::shared_ptr< PPresult > data;
+    QString fileName;
+    // copied from the settings in the GUI thread by selectFile(), the export worker uses only these copies
+    std::vector< QString > voltageColumns;  ///< header of the voltage columns, empty = channel not used
+    std::vector< double > voltageScales;    ///< unit per volt of the voltage columns (math demodulation modes)
+    std::vector< QString > spectrumColumns; ///< header of the spectrum columns, empty = channel not used
 };
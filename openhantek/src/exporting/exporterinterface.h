@@ -9,6 +9,7 @@
 #include <memory>
 
 class ExporterRegistry;
+class ExportWorker;
 class PPresult;
 
 /**
@@ -58,12 +59,21 @@ class ExporterInterface {
     virtual bool samples( const std::shared_ptr< PPresult > ) = 0;
 
     /**
-     * Exporter: Save your received data and perform any conversions necessary.
+     * Exporter: Ask the user for the file name (and further options if required).
      * This method will be called in the
      * GUI thread context and can create and show dialogs if required.
+     * @return Return true if the data shall be written with writeData() otherwise false.
+     */
+    virtual bool selectFile() = 0;
+
+    /**
+     * Exporter: Save your received data to the selected file and perform any conversions necessary.
+     * This method will be called in a background thread, do not access GUI elements. Report the
+     * progress with worker->setProgress() and stop (and remove the partial file) if worker->isCanceled().
+     * The exporter does not receive new samples until the writing is finished.
      * @return Return true if saving succedded otherwise false.
      */
-    virtual bool save() = 0;
+    virtual bool writeData( ExportWorker *worker ) = 0;
 
     /**
      * @brief The progress of receiving and processing samples. If the exporter returns 1, it will
@@ -75,6 +85,12 @@ class ExporterInterface {
      */
     virtual float progress() = 0;
 
+    /**
+     * @return Return true if this exporter needs the compressed ADC samples (PPresult::rawFrame).
+     * The device conversion creates them only while such an exporter is enabled.
+     */
+    virtual bool rawRecording() { return false; }
+
   protected:
     ExporterRegistry *registry;
 };
@@ -2,7 +2,9 @@
 
 #include "exporterregistry.h"
 #include "exporterinterface.h"
+#include "exportworker.h"
 
+#include <QCoreApplication>
 #include <algorithm>
 
 #include "controlspecification.h"
@@ -10,7 +12,14 @@
 #include "post/ppresult.h"
 
 ExporterRegistry::ExporterRegistry( const Dso::ControlSpecification *deviceSpecification, DsoSettings *settings, QObject *parent )
-    : QObject( parent ), deviceSpecification( deviceSpecification ), settings( settings ) {}
+    : QObject( parent ), deviceSpecification( deviceSpecification ), settings( settings ) {
+    // the exporters are destroyed before the registry, stop the background exports in time
+    connect( QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+        cancelExports();
+        for ( auto &exportWorker : exportWorkers )
+            exportWorker.second->wait();
+    } );
+}
 
 bool ExporterRegistry::processData( std::shared_ptr< PPresult > &data, ExporterInterface *const &exporter ) {
     if ( !exporter->samples( data ) ) {
@@ -26,12 +35,14 @@ void ExporterRegistry::addRawSamples( PPresult *d ) {
         return;
     std::shared_ptr< PPresult > data( d );
     enabledExporters.remove_if( [&data, this]( ExporterInterface *const &i ) { return processData( data, i ); } );
+    updateRawRecording();
 }
 
 void ExporterRegistry::input( std::shared_ptr< PPresult > data ) {
-    if ( !settings->exportProcessedSamples )
+    if ( !settings->exportProcessedSamples || data->detail ) // dual timebase: export the overview frames
         return;
     enabledExporters.remove_if( [&data, this]( ExporterInterface *const &i ) { return processData( data, i ); } );
+    updateRawRecording();
 }
 
 void ExporterRegistry::registerExporter( ExporterInterface *exporter ) {
@@ -40,6 +51,10 @@ void ExporterRegistry::registerExporter( ExporterInterface *exporter ) {
 }
 
 void ExporterRegistry::setExporterEnabled( ExporterInterface *exporter, bool enabled ) {
+    if ( exportWorkers.count( exporter ) ) { // the previous data is still written
+        emit exporterStatusChanged( exporter->name(), tr( "Export in progress" ) );
+        return;
+    }
     bool wasInList = false;
     enabledExporters.remove_if( [exporter, &wasInList]( ExporterInterface *inlist ) {
         if ( inlist == exporter ) {
@@ -66,18 +81,67 @@ void ExporterRegistry::setExporterEnabled( ExporterInterface *exporter, bool ena
         } else // Reset exporter
             exporter->create( this );
     }
+    updateRawRecording();
 }
 
+void ExporterRegistry::updateRawRecording() {
+    bool requested = false;
+    for ( ExporterInterface *exporter : enabledExporters )
+        requested |= exporter->rawRecording();
+    if ( requested != rawRecording ) {
+        rawRecording = requested;
+        emit rawRecordingChanged( rawRecording );
+    }
+}
+
+// Select the files in the GUI thread and write them in the background, acquisition and display keep on running
 void ExporterRegistry::checkForWaitingExporters() {
-    for ( ExporterInterface *exporter : waitToSaveExporters ) {
-        if ( exporter->save() ) {
-            emit exporterStatusChanged( exporter->name(), tr( "Data saved" ) );
-        } else {
+    if ( waitToSaveExporters.empty() )
+        return;
+    std::set< ExporterInterface * > exporters;
+    exporters.swap( waitToSaveExporters );
+    for ( ExporterInterface *exporter : exporters ) {
+        if ( !exporter->selectFile() ) {
             emit exporterStatusChanged( exporter->name(), tr( "No data exported" ) );
+            exporter->create( this );
+            continue;
         }
-        exporter->create( this );
+        ExportWorker *exportWorker = new ExportWorker( exporter, this );
+        connect( exportWorker, &ExportWorker::progressChanged, this, &ExporterRegistry::exporterProgressChanged );
+        connect( exportWorker, &QThread::finished, this, [this, exportWorker]() { exportFinished( exportWorker ); } );
+        exportWorkers[ exporter ] = exportWorker;
+        exportWorker->start( QThread::LowPriority );
     }
-    waitToSaveExporters.clear();
+    emit exporterProgressChanged();
+}
+
+void ExporterRegistry::exportFinished( ExportWorker *exportWorker ) {
+    ExporterInterface *exporter = exportWorker->exporter;
+    exportWorkers.erase( exporter );
+    emit exporterProgressChanged();
+    if ( exportWorker->isCanceled() ) {
+        emit exporterStatusChanged( exporter->name(), tr( "Export canceled" ) );
+    } else if ( exportWorker->hasSucceeded() ) {
+        emit exporterStatusChanged( exporter->name(), tr( "Data saved" ) );
+    } else {
+        emit exporterStatusChanged( exporter->name(), tr( "No data exported" ) );
+    }
+    exporter->create( this );
+    exportWorker->deleteLater();
+}
+
+void ExporterRegistry::cancelExports() {
+    for ( auto &exportWorker : exportWorkers )
+        exportWorker.second->cancel();
+}
+
+float ExporterRegistry::exportProgress() const {
+    if ( exportWorkers.empty() )
+        return -1;
+    float progress = 1;
+    for ( const auto &exportWorker : exportWorkers )
+        progress = std::min( progress, exportWorker.second->getProgress() );
+    return progress;
 }
 
 std::vector< ExporterInterface * >::const_iterator ExporterRegistry::begin() { return exporters.begin(); }
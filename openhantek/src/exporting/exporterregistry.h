@@ -3,6 +3,7 @@
 #pragma once
 
 #include <QObject>
+#include <map>
 #include <memory>
 #include <set>
 #include <vector>
@@ -19,6 +20,7 @@ struct ControlSpecification;
 
 // Exporter forwards
 class ExporterInterface;
+class ExportWorker;
 
 class ExporterRegistry : public QObject {
     Q_OBJECT
@@ -36,6 +38,10 @@ class ExporterRegistry : public QObject {
     void setExporterEnabled( ExporterInterface *exporter, bool enabled );
 
     void checkForWaitingExporters();
+    /// Ask all background exports to stop, the partial files are removed.
+    void cancelExports();
+    /// @return The progress of the background exports (0..1) or -1 if no export is running.
+    float exportProgress() const;
 
     // Iterate over this class object
     std::vector< ExporterInterface * >::const_iterator begin();
@@ -52,6 +58,8 @@ class ExporterRegistry : public QObject {
     std::list< ExporterInterface * > enabledExporters;
     /// List of exporters that wait to be called back by the user to save their work
     std::set< ExporterInterface * > waitToSaveExporters;
+    /// Exporters that write their data in the background, they receive no samples until finished
+    std::map< ExporterInterface *, ExportWorker * > exportWorkers;
 
     /// Process data from addRawSamples() or input() in the given exporter. Add the
     /// exporter to waitToSaveExporters if it finishes.
@@ -60,7 +68,15 @@ class ExporterRegistry : public QObject {
     ///     enabledExporters list.
     bool processData( std::shared_ptr< PPresult > &data, ExporterInterface *const &exporter );
 
+    /// Report the result of a background export and reset the exporter.
+    void exportFinished( ExportWorker *worker );
+
+    /// Request the compressed ADC samples from the device if an enabled exporter needs them.
+    void updateRawRecording();
+    bool rawRecording = false;
+
   signals:
     void exporterStatusChanged( const QString &exporterName, const QString &status );
     void exporterProgressChanged();
+    void rawRecordingChanged( bool enabled );
 };
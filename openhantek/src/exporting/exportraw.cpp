@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include "exportraw.h"
+#include "exporterregistry.h"
+#include "exportworker.h"
+#include "iconfont/QtAwesome.h"
+#include "post/ppresult.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QFile>
+#include <QFileDialog>
+
+// keep the compressed frames in memory, the file is written at the end of the recording
+static const size_t RAW_MEMORY_MAX = 256 * 1024 * 1024;
+
+ExporterRaw::ExporterRaw() {}
+
+void ExporterRaw::create( ExporterRegistry *newRegistry ) {
+    this->registry = newRegistry;
+    frames.clear();
+    frames.shrink_to_fit();
+    memory = 0;
+}
+
+int ExporterRaw::faIcon() { return fa::database; }
+
+QString ExporterRaw::name() { return tr( "Record &raw ADC data .." ); }
+
+ExporterInterface::Type ExporterRaw::type() { return Type::ContinousExport; }
+
+bool ExporterRaw::rawRecording() { return true; }
+
+bool ExporterRaw::samples( const std::shared_ptr< PPresult > newData ) {
+    const RawFrame &rawFrame = newData->rawFrame;
+    if ( rawFrame.encoded.empty() ) // recording not yet started by the device or no new data
+        return true;
+    if ( memory + rawFrame.encoded.size() > RAW_MEMORY_MAX )
+        return false;
+    frames.push_back( rawFrame );
+    frames.back().requestTime = newData->requestTime; // place the frames on the real time axis
+    frames.back().completionTime = newData->completionTime;
+    memory += rawFrame.encoded.size();
+    return true;
+}
+
+bool ExporterRaw::selectFile() {
+    if ( frames.empty() )
+        return false;
+    QFileDialog fileDialog( nullptr, tr( "Save raw ADC data" ), QString(), tr( "OpenHantek raw data (*.ohraw)" ) );
+    fileDialog.setFileMode( QFileDialog::AnyFile );
+    fileDialog.setAcceptMode( QFileDialog::AcceptSave );
+    fileDialog.setOption( QFileDialog::DontUseNativeDialog );
+    if ( fileDialog.exec() != QDialog::Accepted )
+        return false;
+    fileName = fileDialog.selectedFiles().first();
+    return true;
+}
+
+// Runs in the export worker thread. File format, all values little endian:
+// "OHRAW001", then for each frame:
+// int64 requestTime, int64 completionTime (ns, monotonic), double samplerate, uint32 oversampling,
+// double offset[ 2 ], double factor[ 2 ], uint32 size, size bytes adcEncode() data
+bool ExporterRaw::writeData( ExportWorker *worker ) {
+    QFile rawFile( fileName );
+    if ( !rawFile.open( QIODevice::WriteOnly ) )
+        return false;
+
+    QDataStream rawStream( &rawFile );
+    rawStream.setByteOrder( QDataStream::LittleEndian );
+    rawStream.setFloatingPointPrecision( QDataStream::DoublePrecision );
+    rawStream.writeRawData( "OHRAW001", 8 );
+    size_t written = 0;
+    for ( const RawFrame &frame : frames ) {
+        if ( worker->isCanceled() ) {
+            rawFile.remove();
+            return false;
+        }
+        worker->setProgress( float( written ) / memory );
+        written += frame.encoded.size();
+        rawStream << qint64( frame.requestTime ) << qint64( frame.completionTime );
+        rawStream << frame.samplerate << quint32( frame.oversampling );
+        rawStream << frame.offset[ 0 ] << frame.offset[ 1 ] << frame.factor[ 0 ] << frame.factor[ 1 ];
+        rawStream << quint32( frame.encoded.size() );
+        rawStream.writeRawData( reinterpret_cast< const char * >( frame.encoded.data() ), int( frame.encoded.size() ) );
+    }
+    rawFile.close();
+
+    return rawStream.status() == QDataStream::Ok;
+}
+
+float ExporterRaw::progress() { return frames.empty() ? 0 : float( memory ) / RAW_MEMORY_MAX; }
@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+#include "exporterinterface.h"
+#include "hantekdso/adccodec.h"
+
+#include <vector>
+
+/// \brief Records the compressed ADC samples of the acquired frames until the user stops the recording
+/// or the memory limit is reached and writes them to a user selected file.
+class ExporterRaw : public ExporterInterface {
+    Q_DECLARE_TR_FUNCTIONS( ExporterRaw )
+
+  public:
+    ExporterRaw();
+    void create( ExporterRegistry *registry ) override;
+    int faIcon() override;
+    QString name() override;
+    Type type() override;
+    bool samples( const std::shared_ptr< PPresult > newData ) override;
+    bool selectFile() override;
+    bool writeData( ExportWorker *worker ) override;
+    float progress() override;
+    bool rawRecording() override;
+
+  private:
+    std::vector< RawFrame > frames; ///< the recorded frames, see adcEncode()
+    size_t memory = 0;              ///< size of the compressed samples
+    QString fileName;               ///< selected by the user, written by writeData()
+};
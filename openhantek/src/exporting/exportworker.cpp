@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include "exportworker.h"
+#include "exporterinterface.h"
+
+
+ExportWorker::ExportWorker( ExporterInterface *exporter, QObject *parent )
+    : QThread( parent ), exporter( exporter ), progress( 0 ), canceled( false ) {
+    setObjectName( "exportWorker" );
+}
+
+
+void ExportWorker::setProgress( float newProgress ) {
+    if ( int( newProgress * 100 ) == int( progress * 100 ) ) // limit the signal rate
+        return;
+    progress = newProgress;
+    emit progressChanged();
+}
+
+
+void ExportWorker::run() { succeeded = exporter->writeData( this ); }
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <QThread>
+#include <atomic>
+
+class ExporterInterface;
+
+/// \brief Writes the data of one exporter in the background, the GUI has already selected the file.
+/// The exporter reports its progress with setProgress() and checks isCanceled() regularly.
+class ExportWorker : public QThread {
+    Q_OBJECT
+
+  public:
+    explicit ExportWorker( ExporterInterface *exporter, QObject *parent = nullptr );
+    /// \brief Called by the exporter (worker thread), signals only changes of at least 1%.
+    void setProgress( float newProgress );
+    float getProgress() const { return progress; }
+    /// \brief Ask the exporter to stop, the partial file is removed.
+    void cancel() { canceled = true; }
+    bool isCanceled() const { return canceled; }
+    bool hasSucceeded() const { return succeeded; }
+
+    ExporterInterface *const exporter;
+
+  signals:
+    void progressChanged();
+
+  private:
+    void run() override;
+    std::atomic< float > progress;
+    std::atomic< bool > canceled;
+    bool succeeded = false;
+};
@@ -11,6 +11,7 @@
 #include <QMouseEvent>
 #include <QOpenGLShaderProgram>
 #include <QPainter>
+#include <QVector4D>
 
 #include <QOffscreenSurface>
 #include <QOpenGLFunctions>
@@ -38,13 +39,14 @@ GlScope *GlScope::createZoomed( DsoSettingsScope *scope, DsoSettingsView *view,
 }
 
 
-void GlScope::useQSurfaceFormat( QSurfaceFormat::RenderableType t ) {
+void GlScope::useQSurfaceFormat( QSurfaceFormat::RenderableType t, bool useMSAA ) {
     QCoreApplication::setAttribute( Qt::AA_ShareOpenGLContexts, true );
 
     // Prefer full desktop OpenGL without fixed pipeline
     QSurfaceFormat format;
-    // TODO: check from time to time if warning has gone, comment next line for now
-    format.setSamples( 4 ); // antialiasing gives warning with some HW, Qt & OpenGL versions.
+    // the graphs are antialiased by the line shader, MSAA multiplies the fill cost on weak GPUs
+    if ( useMSAA )
+        format.setSamples( 4 ); // antialiasing gives warning with some HW, Qt & OpenGL versions.
     format.setProfile( QSurfaceFormat::CoreProfile );
     if ( t == QSurfaceFormat::OpenGLES ) {
         format.setVersion( 2, 0 );
@@ -338,6 +340,247 @@ void GlScope::initializeGL() {
           void main() { flatColor = colour; }
     )";
 
+    // antialiased lines: each vertex of the line strip is stored twice (vertex.z = -1 / +1 = side of the line),
+    // the vertex shader moves them apart perpendicular to the line direction (in pixel) to get a triangle strip
+    // and the fragment shader fades out the border, see LineAttributes.
+    // The declarations depend on the GLSL version, function and main() are the same for all versions.
+    const char *vshaderLineES = R"(
+          #version 100
+          attribute highp vec3 vertex;
+          attribute highp vec3 previous;
+          attribute highp vec3 next;
+          uniform mat4 matrix;
+          uniform highp vec2 viewport;
+          uniform highp float halfWidth;
+          varying highp float edge;
+    )";
+    const char *vshaderLineDesktop120 = R"(
+          #version 120
+          attribute highp vec3 vertex;
+          attribute highp vec3 previous;
+          attribute highp vec3 next;
+          uniform mat4 matrix;
+          uniform highp vec2 viewport;
+          uniform highp float halfWidth;
+          varying highp float edge;
+    )";
+    const char *vshaderLineDesktop150 = R"(
+          #version 150
+          in highp vec3 vertex;
+          in highp vec3 previous;
+          in highp vec3 next;
+          uniform mat4 matrix;
+          uniform highp vec2 viewport;
+          uniform highp float halfWidth;
+          out highp float edge;
+    )";
+    // halfWidth = 0: draw points without expansion
+    // the miter is limited to avoid long spikes at sharp corners
+    const char *vshaderLineFunction = R"(
+          highp vec4 expandLine(highp vec4 position, highp vec4 before, highp vec4 after, highp float side)
+          {
+              highp vec2 p = position.xy * viewport;
+              highp vec2 toPosition = p - before.xy * viewport;
+              highp vec2 toNext = after.xy * viewport - p;
+              if (dot(toPosition, toPosition) < 1e-6)
+                  toPosition = toNext; // first vertex
+              if (dot(toNext, toNext) < 1e-6)
+                  toNext = toPosition; // last vertex
+              if (dot(toPosition, toPosition) < 1e-6) { // single point
+                  toPosition = vec2(1.0, 0.0);
+                  toNext = toPosition;
+              }
+              toPosition = normalize(toPosition);
+              toNext = normalize(toNext);
+              highp vec2 tangent = toPosition + toNext;
+              tangent = dot(tangent, tangent) < 1e-6 ? toPosition : normalize(tangent);
+              highp vec2 normal = vec2(-tangent.y, tangent.x);
+              highp float miter = 1.0 / max(dot(normal, vec2(-toPosition.y, toPosition.x)), 0.5);
+              highp float extent = halfWidth > 0.0 ? halfWidth + 1.0 : 0.0; // add one pixel for the border
+              edge = side * extent;
+              gl_PointSize = 1.0;
+              return vec4(position.xy + normal * (edge * miter) / viewport, position.zw);
+          }
+    )";
+    const char *vshaderLineMain = R"(
+          void main()
+          {
+              gl_Position = expandLine(matrix * vec4(vertex.xy, 0.0, 1.0), matrix * vec4(previous.xy, 0.0, 1.0),
+                                       matrix * vec4(next.xy, 0.0, 1.0), vertex.z);
+          }
+    )";
+    // coverage of the pixel: 1 inside the line, 0.5 at the nominal edge, 0 half a pixel outside
+    const char *fshaderLineES = R"(
+          #version 100
+          uniform highp vec4 colour;
+          uniform highp float halfWidth;
+          varying highp float edge;
+          void main()
+          {
+              highp float coverage = halfWidth > 0.0 ? clamp(halfWidth + 0.5 - abs(edge), 0.0, 1.0) : 1.0;
+              gl_FragColor = vec4(colour.rgb, colour.a * coverage);
+          }
+    )";
+    const char *fshaderLineDesktop120 = R"(
+          #version 120
+          uniform highp vec4 colour;
+          uniform highp float halfWidth;
+          varying highp float edge;
+          void main()
+          {
+              highp float coverage = halfWidth > 0.0 ? clamp(halfWidth + 0.5 - abs(edge), 0.0, 1.0) : 1.0;
+              gl_FragColor = vec4(colour.rgb, colour.a * coverage);
+          }
+    )";
+    const char *fshaderLineDesktop150 = R"(
+          #version 150
+          uniform highp vec4 colour;
+          uniform highp float halfWidth;
+          in highp float edge;
+          out vec4 flatColor;
+          void main()
+          {
+              highp float coverage = halfWidth > 0.0 ? clamp(halfWidth + 0.5 - abs(edge), 0.0, 1.0) : 1.0;
+              flatColor = vec4(colour.rgb, colour.a * coverage);
+          }
+    )";
+
+    // roll mode: the vertex shader scrolls the circular sample buffer, oldest sample (slot rollOffset) on the left side
+    // rollScale = ( left margin, horizontal distance, 1 / gain, offset ), slot = ( slot number, side of the line )
+    // the lines are expanded with expandLine() and drawn with the antialiased line fragment shader
+    const char *vshaderRollES = R"(
+          #version 100
+          attribute highp vec2 slot;
+          attribute highp float value;
+          attribute highp float previous;
+          attribute highp float next;
+          uniform mat4 matrix;
+          uniform highp float rollOffset;
+          uniform highp float rollSize;
+          uniform highp vec4 rollScale;
+          uniform highp vec2 viewport;
+          uniform highp float halfWidth;
+          varying highp float edge;
+    )";
+    const char *vshaderRollDesktop120 = R"(
+          #version 120
+          attribute highp vec2 slot;
+          attribute highp float value;
+          attribute highp float previous;
+          attribute highp float next;
+          uniform mat4 matrix;
+          uniform highp float rollOffset;
+          uniform highp float rollSize;
+          uniform highp vec4 rollScale;
+          uniform highp vec2 viewport;
+          uniform highp float halfWidth;
+          varying highp float edge;
+    )";
+    const char *vshaderRollDesktop150 = R"(
+          #version 150
+          in highp vec2 slot;
+          in highp float value;
+          in highp float previous;
+          in highp float next;
+          uniform mat4 matrix;
+          uniform highp float rollOffset;
+          uniform highp float rollSize;
+          uniform highp vec4 rollScale;
+          uniform highp vec2 viewport;
+          uniform highp float halfWidth;
+          out highp float edge;
+    )";
+    // the oldest (left) and the newest (right) sample have no visible neighbour
+    const char *vshaderRollMain = R"(
+          void main()
+          {
+              highp float position = mod(slot.x - rollOffset + rollSize, rollSize);
+              highp float x = rollScale.x + position * rollScale.y;
+              highp vec4 current = matrix * vec4(x, value * rollScale.z + rollScale.w, 0.0, 1.0);
+              highp vec4 left = position < 0.5 ? current
+                                               : matrix * vec4(x - rollScale.y, previous * rollScale.z + rollScale.w, 0.0, 1.0);
+              highp vec4 right = position > rollSize - 1.5 ? current
+                                                           : matrix * vec4(x + rollScale.y, next * rollScale.z + rollScale.w, 0.0, 1.0);
+              gl_Position = expandLine(current, left, right, slot.y);
+          }
+    )";
+
+    // spectrum persistence: vertex = ( x, y ) in div and ( x, y ) in the density map, the density is graded
+    // logarithmically (1.0 = hit in each frame) to show also rare events, dense areas are brighter and whiter
+    const char *vshaderPersistenceES = R"(
+          #version 100
+          attribute highp vec4 vertex;
+          uniform mat4 matrix;
+          varying highp vec2 texCoord;
+          void main()
+          {
+              gl_Position = matrix * vec4(vertex.xy, 0.0, 1.0);
+              texCoord = vertex.zw;
+          }
+    )";
+    const char *vshaderPersistenceDesktop120 = R"(
+          #version 120
+          attribute highp vec4 vertex;
+          uniform mat4 matrix;
+          varying highp vec2 texCoord;
+          void main()
+          {
+              gl_Position = matrix * vec4(vertex.xy, 0.0, 1.0);
+              texCoord = vertex.zw;
+          }
+    )";
+    const char *vshaderPersistenceDesktop150 = R"(
+          #version 150
+          in highp vec4 vertex;
+          uniform mat4 matrix;
+          out highp vec2 texCoord;
+          void main()
+          {
+              gl_Position = matrix * vec4(vertex.xy, 0.0, 1.0);
+              texCoord = vertex.zw;
+          }
+    )";
+    const char *fshaderPersistenceES = R"(
+          #version 100
+          uniform sampler2D density;
+          uniform highp float densityScale;
+          uniform highp vec4 colour;
+          varying highp vec2 texCoord;
+          void main()
+          {
+              highp float level = clamp(texture2D(density, texCoord).r * densityScale, 0.0, 1.0);
+              highp float grade = log(1.0 + 255.0 * level) / log(256.0);
+              gl_FragColor = vec4(mix(colour.rgb, vec3(1.0), grade * grade), grade);
+          }
+    )";
+    const char *fshaderPersistenceDesktop120 = R"(
+          #version 120
+          uniform sampler2D density;
+          uniform highp float densityScale;
+          uniform highp vec4 colour;
+          varying highp vec2 texCoord;
+          void main()
+          {
+              highp float level = clamp(texture2D(density, texCoord).r * densityScale, 0.0, 1.0);
+              highp float grade = log(1.0 + 255.0 * level) / log(256.0);
+              gl_FragColor = vec4(mix(colour.rgb, vec3(1.0), grade * grade), grade);
+          }
+    )";
+    const char *fshaderPersistenceDesktop150 = R"(
+          #version 150
+          uniform sampler2D density;
+          uniform highp float densityScale;
+          uniform highp vec4 colour;
+          in highp vec2 texCoord;
+          out vec4 flatColor;
+          void main()
+          {
+              highp float level = clamp(texture(density, texCoord).r * densityScale, 0.0, 1.0);
+              highp float grade = log(1.0 + 255.0 * level) / log(256.0);
+              flatColor = vec4(mix(colour.rgb, vec3(1.0), grade * grade), grade);
+          }
+    )";
+
     if ( GlScope::forceGLSLversion )
         GLSLversion = GlScope::forceGLSLversion;
     // qDebug() << "compile shaders" << GlScope::forceGLSLversion << GLSLversion;
@@ -368,6 +611,113 @@ void GlScope::initializeGL() {
         return;
     }
 
+    // Antialiased line shader pipeline
+    const char *fshaderLineDesktop = GLSLversion == 120 ? fshaderLineDesktop120 : fshaderLineDesktop150;
+    auto lineProgram = std::unique_ptr< QOpenGLShaderProgram >( new QOpenGLShaderProgram( context() ) );
+    const char *vshaderLineDesktop = GLSLversion == 120 ? vshaderLineDesktop120 : vshaderLineDesktop150;
+    if ( !lineProgram->addShaderFromSourceCode( QOpenGLShader::Vertex, QByteArray( usesOpenGL ? vshaderLineDesktop : vshaderLineES ) +
+                                                                           vshaderLineFunction + vshaderLineMain ) ||
+         !lineProgram->addShaderFromSourceCode( QOpenGLShader::Fragment, usesOpenGL ? fshaderLineDesktop : fshaderLineES ) ) {
+        errorMessage = tr( "Failed to compile OpenGL shader programs.\n" ) + lineProgram->log();
+        return;
+    }
+    if ( !lineProgram->link() ) {
+        errorMessage = tr( "Failed to link/bind OpenGL shader programs.\n" ) + lineProgram->log();
+        return;
+    }
+    lineAttributes.vertex = lineProgram->attributeLocation( "vertex" );
+    lineAttributes.previous = lineProgram->attributeLocation( "previous" );
+    lineAttributes.next = lineProgram->attributeLocation( "next" );
+    lineMatrixLocation = lineProgram->uniformLocation( "matrix" );
+    lineColorLocation = lineProgram->uniformLocation( "colour" );
+    lineViewportLocation = lineProgram->uniformLocation( "viewport" );
+    lineHalfWidthLocation = lineProgram->uniformLocation( "halfWidth" );
+    if ( lineAttributes.vertex == -1 || lineAttributes.previous == -1 || lineAttributes.next == -1 || lineMatrixLocation == -1 ||
+         lineColorLocation == -1 || lineViewportLocation == -1 || lineHalfWidthLocation == -1 ) {
+        qWarning() << tr( "Failed to locate shader variable." );
+        return;
+    }
+    m_lineProgram = std::move( lineProgram );
+
+    // Roll mode shader pipeline
+    auto rollProgram = std::unique_ptr< QOpenGLShaderProgram >( new QOpenGLShaderProgram( context() ) );
+    const char *vshaderRollDesktop = GLSLversion == 120 ? vshaderRollDesktop120 : vshaderRollDesktop150;
+    if ( !rollProgram->addShaderFromSourceCode( QOpenGLShader::Vertex, QByteArray( usesOpenGL ? vshaderRollDesktop : vshaderRollES ) +
+                                                                           vshaderLineFunction + vshaderRollMain ) ||
+         !rollProgram->addShaderFromSourceCode( QOpenGLShader::Fragment, usesOpenGL ? fshaderLineDesktop : fshaderLineES ) ) {
+        errorMessage = tr( "Failed to compile OpenGL shader programs.\n" ) + rollProgram->log();
+        return;
+    }
+    if ( !rollProgram->link() ) {
+        errorMessage = tr( "Failed to link/bind OpenGL shader programs.\n" ) + rollProgram->log();
+        return;
+    }
+    rollAttributes.slot = rollProgram->attributeLocation( "slot" );
+    rollAttributes.value = rollProgram->attributeLocation( "value" );
+    rollAttributes.previous = rollProgram->attributeLocation( "previous" );
+    rollAttributes.next = rollProgram->attributeLocation( "next" );
+    rollMatrixLocation = rollProgram->uniformLocation( "matrix" );
+    rollColorLocation = rollProgram->uniformLocation( "colour" );
+    rollOffsetLocation = rollProgram->uniformLocation( "rollOffset" );
+    rollSizeLocation = rollProgram->uniformLocation( "rollSize" );
+    rollScaleLocation = rollProgram->uniformLocation( "rollScale" );
+    rollViewportLocation = rollProgram->uniformLocation( "viewport" );
+    rollHalfWidthLocation = rollProgram->uniformLocation( "halfWidth" );
+    if ( rollAttributes.slot == -1 || rollAttributes.value == -1 || rollAttributes.previous == -1 || rollAttributes.next == -1 ||
+         rollMatrixLocation == -1 || rollColorLocation == -1 || rollOffsetLocation == -1 || rollSizeLocation == -1 ||
+         rollScaleLocation == -1 || rollViewportLocation == -1 || rollHalfWidthLocation == -1 ) {
+        qWarning() << tr( "Failed to locate shader variable." );
+        return;
+    }
+    m_rollGraphs.clear();
+    for ( ChannelID channel = 0; channel < scope->voltage.size(); ++channel )
+        m_rollGraphs.push_back( std::unique_ptr< RollGraph >( new RollGraph ) );
+    m_rollProgram = std::move( rollProgram );
+
+    // Spectrum persistence pipeline (optional), needs one channel float textures
+    const bool floatTextures = context()->format().majorVersion() >= 3 ||
+                               ( !context()->isOpenGLES() && context()->hasExtension( "GL_ARB_texture_rg" ) &&
+                                 context()->hasExtension( "GL_ARB_texture_float" ) );
+    auto persistenceProgram = std::unique_ptr< QOpenGLShaderProgram >( new QOpenGLShaderProgram( context() ) );
+    const char *vshaderPersistenceDesktop = GLSLversion == 120 ? vshaderPersistenceDesktop120 : vshaderPersistenceDesktop150;
+    const char *fshaderPersistenceDesktop = GLSLversion == 120 ? fshaderPersistenceDesktop120 : fshaderPersistenceDesktop150;
+    m_persistence.clear();
+    if ( floatTextures &&
+         persistenceProgram->addShaderFromSourceCode( QOpenGLShader::Vertex,
+                                                      usesOpenGL ? vshaderPersistenceDesktop : vshaderPersistenceES ) &&
+         persistenceProgram->addShaderFromSourceCode( QOpenGLShader::Fragment,
+                                                      usesOpenGL ? fshaderPersistenceDesktop : fshaderPersistenceES ) &&
+         persistenceProgram->link() ) {
+        persistenceVertexLocation = persistenceProgram->attributeLocation( "vertex" );
+        persistenceMatrixLocation = persistenceProgram->uniformLocation( "matrix" );
+        persistenceColorLocation = persistenceProgram->uniformLocation( "colour" );
+        persistenceScaleLocation = persistenceProgram->uniformLocation( "densityScale" );
+        persistenceDensityLocation = persistenceProgram->uniformLocation( "density" );
+        if ( persistenceVertexLocation != -1 && persistenceMatrixLocation != -1 && persistenceColorLocation != -1 &&
+             persistenceScaleLocation != -1 && persistenceDensityLocation != -1 ) {
+            // the quad covers the screen, the density map is stretched to the screen size
+            const GLfloat quad[] = {GLfloat( MARGIN_LEFT ),  GLfloat( MARGIN_BOTTOM ), 0, 0,
+                                    GLfloat( MARGIN_RIGHT ), GLfloat( MARGIN_BOTTOM ), 1, 0,
+                                    GLfloat( MARGIN_LEFT ),  GLfloat( MARGIN_TOP ),    0, 1,
+                                    GLfloat( MARGIN_RIGHT ), GLfloat( MARGIN_TOP ),    1, 1};
+            persistenceProgram->bind();
+            m_vaoPersistence.create();
+            QOpenGLVertexArrayObject::Binder b( &m_vaoPersistence );
+            m_persistenceQuad.create();
+            m_persistenceQuad.bind();
+            m_persistenceQuad.setUsagePattern( QOpenGLBuffer::StaticDraw );
+            m_persistenceQuad.allocate( quad, int( sizeof( quad ) ) );
+            persistenceProgram->enableAttributeArray( persistenceVertexLocation );
+            persistenceProgram->setAttributeBuffer( persistenceVertexLocation, GL_FLOAT, 0, 4, 0 );
+            auto *gl = context()->functions();
+            for ( ChannelID channel = 0; channel < scope->spectrum.size(); ++channel )
+                m_persistence.push_back( std::unique_ptr< SpectrumPersistence >( new SpectrumPersistence( gl ) ) );
+            m_persistenceProgram = std::move( persistenceProgram );
+        }
+    }
+    if ( !m_persistenceProgram )
+        qWarning() << tr( "Spectrum persistence is not available" ) << persistenceProgram->log();
+
     program->bind();
 
     auto *gl = context()->functions();
@@ -421,7 +771,27 @@ void GlScope::showData( std::shared_ptr< PPresult > newData ) {
     m_GraphHistory.splice( m_GraphHistory.begin(), m_GraphHistory, std::prev( m_GraphHistory.end() ) );
 
     // Add new entry
-    m_GraphHistory.front().writeData( newData.get(), m_program.get(), vertexLocation );
+    m_GraphHistory.front().writeData( newData.get(), m_program.get(), vertexLocation, m_lineProgram.get(), lineAttributes );
+    // Roll mode: append only the new samples to the circular buffers
+    for ( ChannelID channel = 0; channel < m_rollGraphs.size(); ++channel ) {
+        RollGraph &rollGraph = *m_rollGraphs[ channel ];
+        rollGraph.active = GraphGenerator::useRollGraph( newData.get(), scope, view, channel );
+        if ( rollGraph.active )
+            rollGraph.writeData( newData->data( channel )->voltage, newData->rollTotal, m_rollProgram.get(), rollAttributes );
+        else
+            rollGraph.invalidate();
+    }
+    // Spectrum persistence: add the new spectra to the density maps
+    for ( ChannelID channel = 0; channel < m_persistence.size(); ++channel ) {
+        SpectrumPersistence &persistence = *m_persistence[ channel ];
+        if ( usePersistence( channel ) && channel < newData->vaChannelSpectrum.size() ) {
+            persistence.setGeometry( scope->horizontal.frequencybase, scope->spectrum[ channel ].magnitude,
+                                     scope->spectrum[ channel ].offset );
+            persistence.writeData( newData->vaChannelSpectrum[ channel ], view->spectrumPersistence );
+        } else {
+            persistence.clear();
+        }
+    }
     // doneCurrent();
 
     update();
@@ -495,29 +865,54 @@ void GlScope::paintGL() {
     m_program->bind();
 
     // Apply zoom settings via matrix transformation
+    QMatrix4x4 graphMatrix = pmvMatrix;
     if ( zoomed ) {
         QMatrix4x4 m;
         m.scale( QVector3D( GLfloat( DIVS_TIME ) / GLfloat( fabs( scope->getMarker( 1 ) - scope->getMarker( 0 ) ) ), 1.0f, 1.0f ) );
         m.translate( -GLfloat( scope->getMarker( 0 ) + scope->getMarker( 1 ) ) / 2, 0.0f, 0.0f );
-        m_program->setUniformValue( matrixLocation, pmvMatrix * m );
+        graphMatrix = pmvMatrix * m;
+        m_program->setUniformValue( matrixLocation, graphMatrix );
     }
 
     drawMarkers();
 
-    unsigned historyIndex = 0;
-    for ( Graph &graph : m_GraphHistory ) {
+    // antialiased graphs: the triangle strips may change their orientation (no culling)
+    // and must not hide each other with their transparent border (no depth writes)
+    gl->glDisable( GL_CULL_FACE );
+    gl->glDepthMask( GL_FALSE );
+    // line width in pixel, 0 = draw points
+    const GLfloat halfWidth =
+        ( view->interpolation == Dso::INTERPOLATION_OFF ) ? 0.0f : GLfloat( view->traceWidth * devicePixelRatio() / 2 );
+    m_lineProgram->bind();
+    m_lineProgram->setUniformValue( lineMatrixLocation, graphMatrix );
+    m_lineProgram->setUniformValue( lineViewportLocation, viewport );
+    m_lineProgram->setUniformValue( lineHalfWidthLocation, halfWidth );
+
+    // the spectrum persistence replaces the spectrum graphs and is drawn below all graphs
+    for ( ChannelID channel = 0; channel < m_persistence.size(); ++channel )
+        drawSpectrumPersistence( channel, *m_persistence[ channel ], graphMatrix );
+
+    // draw the oldest graph first, the newest graph is on top
+    int historyIndex = int( m_GraphHistory.size() );
+    for ( auto graph = m_GraphHistory.rbegin(); graph != m_GraphHistory.rend(); ++graph ) {
+        --historyIndex;
         for ( ChannelID channel = 0; channel < scope->voltage.size(); ++channel ) {
             if ( scope->horizontal.format == Dso::GraphFormat::TY ) {
-                drawSpectrumChannelGraph( channel, graph, int( historyIndex ) );
+                drawSpectrumChannelGraph( channel, *graph, historyIndex );
                 if ( scope->histogram ) {
-                    drawHistogramChannelGraph( channel, graph, int( historyIndex ) );
+                    drawHistogramChannelGraph( channel, *graph, historyIndex );
                 }
             }
-            drawVoltageChannelGraph( channel, graph, int( historyIndex ) );
+            drawVoltageChannelGraph( channel, *graph, historyIndex );
         }
-        ++historyIndex;
     }
 
+    for ( ChannelID channel = 0; channel < m_rollGraphs.size(); ++channel )
+        drawRollChannelGraph( channel, *m_rollGraphs[ channel ], graphMatrix, halfWidth );
+    gl->glDepthMask( GL_TRUE );
+    gl->glEnable( GL_CULL_FACE );
+    m_program->bind();
+
     if ( zoomed ) {
         m_program->setUniformValue( matrixLocation, pmvMatrix );
     }
@@ -532,6 +927,7 @@ void GlScope::resizeGL( int width, int height ) {
         return;
     auto *gl = context()->functions();
     gl->glViewport( 0, 0, GLint( width ), GLint( height ) );
+    viewport = QVector2D( width, height ) * devicePixelRatio() / 2;
 
     // Set axes to div-scale and apply correction for exact pixelization
     float pixelizationWidthCorrection = float( width ) / ( width - 1 );
@@ -795,11 +1191,12 @@ void GlScope::drawVoltageChannelGraph( ChannelID channel, Graph &graph, int hist
     if ( !scope->voltage[ channel ].used )
         return;
 
-    m_program->setUniformValue( colorLocation, view->colors->voltage[ channel ].darker( 100 + 10 * historyIndex ) );
+    m_lineProgram->bind();
+    m_lineProgram->setUniformValue( lineColorLocation, view->colors->voltage[ channel ].darker( 100 + 10 * historyIndex ) );
     Graph::VaoCount &v = graph.vaoVoltage[ channel ];
 
     QOpenGLVertexArrayObject::Binder b( v.first );
-    const GLenum dMode = ( view->interpolation == Dso::INTERPOLATION_OFF ) ? GL_POINTS : GL_LINE_STRIP;
+    const GLenum dMode = ( view->interpolation == Dso::INTERPOLATION_OFF ) ? GL_POINTS : GL_TRIANGLE_STRIP;
     context()->functions()->glDrawArrays( dMode, 0, v.second );
 }
 
@@ -808,6 +1205,7 @@ void GlScope::drawHistogramChannelGraph( ChannelID channel, Graph &graph, int hi
     if ( !scope->voltage[ channel ].used )
         return;
 
+    m_program->bind();
     m_program->setUniformValue( colorLocation, view->colors->voltage[ channel ].darker( 100 + 10 * historyIndex ) );
     Graph::VaoCount &h = graph.vaoHistogram[ channel ];
 
@@ -818,13 +1216,64 @@ void GlScope::drawHistogramChannelGraph( ChannelID channel, Graph &graph, int hi
 
 
 void GlScope::drawSpectrumChannelGraph( ChannelID channel, Graph &graph, int historyIndex ) {
-    if ( !scope->spectrum[ channel ].used )
+    if ( !scope->spectrum[ channel ].used || usePersistence( channel ) )
         return;
 
-    m_program->setUniformValue( colorLocation, view->colors->spectrum[ channel ].darker( 100 + 10 * historyIndex ) );
+    m_lineProgram->bind();
+    m_lineProgram->setUniformValue( lineColorLocation, view->colors->spectrum[ channel ].darker( 100 + 10 * historyIndex ) );
     Graph::VaoCount &v = graph.vaoSpectrum[ channel ];
 
     QOpenGLVertexArrayObject::Binder b( v.first );
-    const GLenum dMode = ( view->interpolation == Dso::INTERPOLATION_OFF ) ? GL_POINTS : GL_LINE_STRIP;
+    const GLenum dMode = ( view->interpolation == Dso::INTERPOLATION_OFF ) ? GL_POINTS : GL_TRIANGLE_STRIP;
     context()->functions()->glDrawArrays( dMode, 0, v.second );
 }
+
+
+void GlScope::drawRollChannelGraph( ChannelID channel, RollGraph &graph, const QMatrix4x4 &matrix, GLfloat halfWidth ) {
+    if ( !graph.active || !graph.size || !scope->voltage[ channel ].used )
+        return;
+
+    m_rollProgram->bind();
+    m_rollProgram->setUniformValue( rollMatrixLocation, matrix );
+    m_rollProgram->setUniformValue( rollColorLocation, view->colors->voltage[ channel ] );
+    m_rollProgram->setUniformValue( rollOffsetLocation, GLfloat( graph.offset ) );
+    m_rollProgram->setUniformValue( rollSizeLocation, GLfloat( graph.size ) );
+    m_rollProgram->setUniformValue( rollViewportLocation, viewport );
+    m_rollProgram->setUniformValue( rollHalfWidthLocation, halfWidth );
+    m_rollProgram->setUniformValue( rollScaleLocation,
+                                    QVector4D( GLfloat( MARGIN_LEFT ), GLfloat( graph.interval / scope->horizontal.timebase ),
+                                               GLfloat( 1.0 / scope->gain( channel ) ), GLfloat( scope->voltage[ channel ].offset ) ) );
+
+    QOpenGLVertexArrayObject::Binder b( &graph.vao );
+    const GLenum dMode = ( view->interpolation == Dso::INTERPOLATION_OFF ) ? GL_POINTS : GL_TRIANGLE_STRIP;
+    auto *gl = context()->functions();
+    // oldest samples up to the end of the buffer (plus the copy of slot 0), then the wrapped newest samples
+    // each slot has two vertices, one for each side of the line
+    gl->glDrawArrays( dMode, 2 * graph.offset, 2 * ( graph.size - graph.offset + ( graph.offset ? 1 : 0 ) ) );
+    if ( graph.offset )
+        gl->glDrawArrays( dMode, 0, 2 * graph.offset );
+}
+
+
+bool GlScope::usePersistence( ChannelID channel ) const {
+    return m_persistenceProgram && view->spectrumPersistence > 0 && scope->horizontal.format == Dso::GraphFormat::TY &&
+           channel < m_persistence.size() && scope->spectrum[ channel ].used;
+}
+
+
+void GlScope::drawSpectrumPersistence( ChannelID channel, SpectrumPersistence &persistence, const QMatrix4x4 &matrix ) {
+    if ( !usePersistence( channel ) )
+        return;
+
+    auto *gl = context()->functions();
+    m_persistenceProgram->bind();
+    m_persistenceProgram->setUniformValue( persistenceMatrixLocation, matrix );
+    m_persistenceProgram->setUniformValue( persistenceColorLocation, view->colors->spectrum[ channel ] );
+    m_persistenceProgram->setUniformValue( persistenceScaleLocation, persistence.scale );
+    m_persistenceProgram->setUniformValue( persistenceDensityLocation, 0 ); // texture unit 0
+    gl->glActiveTexture( GL_TEXTURE0 );
+    gl->glBindTexture( GL_TEXTURE_2D, persistence.texture );
+    QOpenGLVertexArrayObject::Binder b( &m_vaoPersistence );
+    gl->glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+    gl->glBindTexture( GL_TEXTURE_2D, 0 );
+}
@@ -10,9 +10,12 @@
 #include <QOpenGLShaderProgram>
 #include <QOpenGLVertexArrayObject>
 #include <QOpenGLWidget>
+#include <QVector2D>
 #include <QtGlobal>
 
 #include "glscopegraph.h"
+#include "glscopepersistence.h"
+#include "glscoperollgraph.h"
 #include "hantekdso/enums.h"
 #include "hantekprotocol/types.h"
 
@@ -32,8 +35,10 @@ class GlScope : public QOpenGLWidget {
     /**
      * We need at least OpenGL 3.2 with shader version 150 (else version 120) or
      * OpenGL ES 2.0 with shader version 100.
+     * The graphs are antialiased by the line shader, multisampling (MSAA) is only used on request.
      */
-    static void useQSurfaceFormat( QSurfaceFormat::RenderableType t = QSurfaceFormat::DefaultRenderableType );
+    static void useQSurfaceFormat( QSurfaceFormat::RenderableType t = QSurfaceFormat::DefaultRenderableType,
+                                   bool useMSAA = false );
     // force either GLSL version 1.20 or 1.50
     static void useOpenGLSLversion( unsigned version ) { forceGLSLversion = version; }
     /**
@@ -84,6 +89,9 @@ class GlScope : public QOpenGLWidget {
     void drawVoltageChannelGraph( ChannelID channel, Graph &graph, int historyIndex );
     void drawHistogramChannelGraph( ChannelID channel, Graph &graph, int historyIndex );
     void drawSpectrumChannelGraph( ChannelID channel, Graph &graph, int historyIndex );
+    void drawRollChannelGraph( ChannelID channel, RollGraph &graph, const QMatrix4x4 &matrix, GLfloat halfWidth );
+    void drawSpectrumPersistence( ChannelID channel, SpectrumPersistence &persistence, const QMatrix4x4 &matrix );
+    bool usePersistence( ChannelID channel ) const;
     QPointF posToPosition( QPointF pos );
   signals:
     void markerMoved( unsigned cursorIndex, unsigned marker );
@@ -122,6 +130,7 @@ class GlScope : public QOpenGLWidget {
     // Graphs
     std::list< Graph > m_GraphHistory;
     unsigned currentGraphInHistory = 0;
+    std::vector< std::unique_ptr< RollGraph > > m_rollGraphs; ///< one circular GPU buffer per channel
 
     // OpenGL shader, matrix, var-locations
     unsigned int GLSLversion = 150;
@@ -134,4 +143,32 @@ class GlScope : public QOpenGLWidget {
     int vertexLocation;
     int matrixLocation;
     int selectionLocation;
+    QVector2D viewport; ///< half size of the viewport in pixel
+    // Antialiased line shader, the vertex shader expands the line strips to triangle strips
+    std::unique_ptr< QOpenGLShaderProgram > m_lineProgram;
+    LineAttributes lineAttributes;
+    int lineMatrixLocation;
+    int lineColorLocation;
+    int lineViewportLocation;
+    int lineHalfWidthLocation;
+    // Roll mode shader, the vertex shader scrolls the circular buffer
+    std::unique_ptr< QOpenGLShaderProgram > m_rollProgram;
+    RollAttributes rollAttributes;
+    int rollMatrixLocation;
+    int rollColorLocation;
+    int rollOffsetLocation;
+    int rollSizeLocation;
+    int rollScaleLocation;
+    int rollViewportLocation;
+    int rollHalfWidthLocation;
+    // Spectrum persistence shader, draws the density map texture on a screen sized quad
+    std::unique_ptr< QOpenGLShaderProgram > m_persistenceProgram;
+    std::vector< std::unique_ptr< SpectrumPersistence > > m_persistence; ///< one density map per channel
+    QOpenGLBuffer m_persistenceQuad;
+    QOpenGLVertexArrayObject m_vaoPersistence;
+    int persistenceVertexLocation;
+    int persistenceMatrixLocation;
+    int persistenceColorLocation;
+    int persistenceScaleLocation;
+    int persistenceDensityLocation;
 };
@@ -9,15 +9,22 @@ Graph::Graph() : buffer( QOpenGLBuffer::VertexBuffer ) {
     buffer.setUsagePattern( QOpenGLBuffer::DynamicDraw );
 }
 
-void Graph::writeData( PPresult *data, QOpenGLShaderProgram *program, int vertexLocation ) {
+// the line strips are expanded to 2 vertices per point plus 2 * 2 neighbours at both ends
+static int lineStripMemory( const ChannelGraph &strip ) {
+    return strip.empty() ? 0 : int( ( 2 * strip.size() + 4 ) * sizeof( QVector3D ) );
+}
+
+
+void Graph::writeData( PPresult *data, QOpenGLShaderProgram *program, int vertexLocation, QOpenGLShaderProgram *lineProgram,
+                       const LineAttributes &line ) {
     // Determine memory
     int neededMemory = 0;
     for ( ChannelGraph &cg : data->vaChannelVoltage )
-        neededMemory += int( cg.size() * sizeof( QVector3D ) );
+        neededMemory += lineStripMemory( cg );
     for ( ChannelGraph &cg : data->vaChannelHistogram )
         neededMemory += int( cg.size() * sizeof( QVector3D ) );
     for ( ChannelGraph &cg : data->vaChannelSpectrum )
-        neededMemory += int( cg.size() * sizeof( QVector3D ) );
+        neededMemory += lineStripMemory( cg );
 
     buffer.bind();
     program->bind();
@@ -47,13 +54,9 @@ void Graph::writeData( PPresult *data, QOpenGLShaderProgram *program, int vertex
             }
             ChannelGraph &gVoltage = data->vaChannelVoltage[ channel ];
             v.first->bind();
-            dataSize = int( gVoltage.size() * sizeof( QVector3D ) );
-            buffer.write( offset, gVoltage.data(), dataSize );
-            program->enableAttributeArray( vertexLocation );
-            program->setAttributeBuffer( vertexLocation, GL_FLOAT, offset, 3, 0 );
+            offset += writeLineStrip( gVoltage, offset, lineProgram, line );
             v.first->release();
-            v.second = int( gVoltage.size() );
-            offset += dataSize;
+            v.second = int( 2 * gVoltage.size() );
         }
 
         // Histogram channel
@@ -85,19 +88,42 @@ void Graph::writeData( PPresult *data, QOpenGLShaderProgram *program, int vertex
             }
             ChannelGraph &gSpectrum = data->vaChannelSpectrum[ channel ];
             s.first->bind();
-            dataSize = int( gSpectrum.size() * sizeof( QVector3D ) );
-            buffer.write( offset, gSpectrum.data(), dataSize );
-            program->enableAttributeArray( vertexLocation );
-            program->setAttributeBuffer( vertexLocation, GL_FLOAT, offset, 3, 0 );
+            offset += writeLineStrip( gSpectrum, offset, lineProgram, line );
             s.first->release();
-            s.second = int( gSpectrum.size() );
-            offset += dataSize;
+            s.second = int( 2 * gSpectrum.size() );
         }
     }
 
     buffer.release();
 }
 
+
+// Write the expanded line strip (see LineAttributes) into the bound VAO, return the used memory
+int Graph::writeLineStrip( const ChannelGraph &strip, int offset, QOpenGLShaderProgram *lineProgram, const LineAttributes &line ) {
+    lineVertices.clear();
+    if ( !strip.empty() ) {
+        lineVertices.reserve( 2 * strip.size() + 4 );
+        lineVertices.push_back( QVector3D( strip.front().x(), strip.front().y(), -1 ) ); // neighbour of the 1st vertex
+        lineVertices.push_back( QVector3D( strip.front().x(), strip.front().y(), 1 ) );
+        for ( const QVector3D &vertex : strip ) {
+            lineVertices.push_back( QVector3D( vertex.x(), vertex.y(), -1 ) );
+            lineVertices.push_back( QVector3D( vertex.x(), vertex.y(), 1 ) );
+        }
+        lineVertices.push_back( QVector3D( strip.back().x(), strip.back().y(), -1 ) ); // neighbour of the last vertex
+        lineVertices.push_back( QVector3D( strip.back().x(), strip.back().y(), 1 ) );
+    }
+    const int dataSize = int( lineVertices.size() * sizeof( QVector3D ) );
+    const int vertexSize = int( sizeof( QVector3D ) );
+    buffer.write( offset, lineVertices.data(), dataSize );
+    lineProgram->enableAttributeArray( line.previous );
+    lineProgram->setAttributeBuffer( line.previous, GL_FLOAT, offset, 3, 0 );
+    lineProgram->enableAttributeArray( line.vertex );
+    lineProgram->setAttributeBuffer( line.vertex, GL_FLOAT, offset + 2 * vertexSize, 3, 0 );
+    lineProgram->enableAttributeArray( line.next );
+    lineProgram->setAttributeBuffer( line.next, GL_FLOAT, offset + 4 * vertexSize, 3, 0 );
+    return dataSize;
+}
+
 Graph::~Graph() {
     for ( auto &vao : vaoVoltage ) {
         vao.first->destroy();
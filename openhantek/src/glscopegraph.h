@@ -13,12 +13,23 @@
 
 #include "post/ppresult.h"
 
+/// \brief Attribute locations of the antialiased line shader.
+/// The line strips are stored with each vertex twice (z = -1 / +1 selects the side of the line)
+/// and the first and last vertex repeated, `previous` and `next` read the neighbours of `vertex`
+/// from the same buffer with an offset of -/+ two vertices.
+struct LineAttributes {
+    int vertex;
+    int previous;
+    int next;
+};
+
 struct Graph {
     explicit Graph();
     Graph( const Graph & ) = delete;
     Graph( const Graph && ) = delete;
     ~Graph();
-    void writeData( PPresult *data, QOpenGLShaderProgram *program, int vertexLocation );
+    void writeData( PPresult *data, QOpenGLShaderProgram *program, int vertexLocation, QOpenGLShaderProgram *lineProgram,
+                    const LineAttributes &line );
     typedef std::pair< QOpenGLVertexArrayObject *, GLsizei > VaoCount;
 
   public:
@@ -27,4 +38,8 @@ struct Graph {
     std::vector< VaoCount > vaoVoltage;
     std::vector< VaoCount > vaoHistogram;
     std::vector< VaoCount > vaoSpectrum;
+
+  private:
+    int writeLineStrip( const ChannelGraph &strip, int offset, QOpenGLShaderProgram *lineProgram, const LineAttributes &line );
+    ChannelGraph lineVertices; ///< expanded line strip, see LineAttributes
 };
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <QOpenGLContext>
+#include <algorithm>
+#include <cmath>
+
+#include "glscopepersistence.h"
+#include "viewconstants.h"
+
+// one channel float textures (OpenGL 3.0, OpenGL ES 3.0, GL_ARB_texture_rg)
+#ifndef GL_RED
+#define GL_RED 0x1903
+#endif
+#ifndef GL_R32F
+#define GL_R32F 0x822E
+#endif
+
+// renormalize the density map long before the float range is exhausted
+static const double WEIGHT_MAX = 1e20;
+
+
+SpectrumPersistence::SpectrumPersistence( QOpenGLFunctions *gl ) : gl( gl ) {
+    density.assign( size_t( ROWS * COLUMNS ), 0 );
+    gl->glGenTextures( 1, &texture );
+    gl->glBindTexture( GL_TEXTURE_2D, texture );
+    gl->glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST ); // float textures are not filterable on GLES
+    gl->glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    gl->glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    gl->glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+    gl->glTexImage2D( GL_TEXTURE_2D, 0, GL_R32F, COLUMNS, ROWS, 0, GL_RED, GL_FLOAT, density.data() );
+    gl->glBindTexture( GL_TEXTURE_2D, 0 );
+}
+
+
+void SpectrumPersistence::writeData( const ChannelGraph &graph, double timeConstant ) {
+    if ( graph.empty() || timeConstant <= 0 )
+        return;
+    // the decay depends on the time between the frames, not on the number of frames
+    double elapsed = 0.0;
+    if ( frameTimer.isValid() ) {
+        elapsed = qMin( frameTimer.restart() / 1000.0, 10 * timeConstant );
+        frameInterval += ( elapsed - frameInterval ) / 8;
+    } else {
+        frameTimer.start();
+    }
+    const double decay = exp( -elapsed / timeConstant );
+    int firstIndex = ROWS * COLUMNS;
+    int lastIndex = -1;
+    if ( weight / decay > WEIGHT_MAX ) { // scale the old hits down, upload the complete map
+        for ( GLfloat &value : density )
+            value = GLfloat( value / weight );
+        weight = 1.0;
+        firstIndex = 0;
+        lastIndex = ROWS * COLUMNS - 1;
+    }
+    weight /= decay;
+
+    // map index of each hit, one hit per bin, or one hit per column if the bins are wider (linear interpolation)
+    const size_t count = graph.size();
+    const float xFactor = float( COLUMNS / DIVS_TIME );
+    const float yFactor = float( ROWS / DIVS_VOLTAGE );
+    const float xOffset = float( -MARGIN_LEFT );
+    const float yOffset = float( -MARGIN_BOTTOM );
+    if ( count >= size_t( COLUMNS ) ) {
+        hits.resize( count );
+        for ( size_t index = 0; index < count; ++index ) { // independent iterations, vectorised by the compiler
+            const float column = ( graph[ index ].x() + xOffset ) * xFactor;
+            const float row = ( graph[ index ].y() + yOffset ) * yFactor;
+            const bool visible = column >= 0 && column < COLUMNS && row >= 0 && row < ROWS;
+            hits[ index ] = visible ? int( row ) * COLUMNS + int( column ) : -1;
+        }
+    } else {
+        hits.resize( size_t( COLUMNS ) );
+        size_t index = 0;
+        for ( int column = 0; column < COLUMNS; ++column ) {
+            const float x = ( column + 0.5f ) / xFactor - xOffset; // centre of the column in div
+            while ( index + 2 < count && graph[ index + 1 ].x() < x )
+                ++index;
+            const QVector3D &left = graph[ index ];
+            const QVector3D &right = graph[ qMin( index + 1, count - 1 ) ];
+            hits[ size_t( column ) ] = -1;
+            if ( x < left.x() || x > right.x() || right.x() <= left.x() )
+                continue;
+            const float y = left.y() + ( right.y() - left.y() ) * ( x - left.x() ) / ( right.x() - left.x() );
+            const float row = ( y + yOffset ) * yFactor;
+            if ( row >= 0 && row < ROWS )
+                hits[ size_t( column ) ] = int( row ) * COLUMNS + column;
+        }
+    }
+
+    // add the hits, only the touched rows are uploaded
+    const GLfloat hitWeight = GLfloat( weight );
+    for ( const int hit : hits ) {
+        if ( hit < 0 )
+            continue;
+        density[ size_t( hit ) ] += hitWeight;
+        firstIndex = std::min( firstIndex, hit );
+        lastIndex = std::max( lastIndex, hit );
+    }
+    if ( lastIndex >= 0 )
+        upload( firstIndex / COLUMNS, lastIndex / COLUMNS - firstIndex / COLUMNS + 1 );
+    scale = GLfloat( ( 1.0 - exp( -frameInterval / timeConstant ) ) / weight );
+    empty = false;
+}
+
+
+void SpectrumPersistence::setGeometry( double frequencybase, double magnitude, double offset ) {
+    const QVector3D newGeometry( float( frequencybase ), float( magnitude ), float( offset ) );
+    if ( newGeometry == geometry ) // fuzzy compare
+        return;
+    geometry = newGeometry;
+    clear();
+}
+
+
+void SpectrumPersistence::clear() {
+    if ( empty )
+        return;
+    std::fill( density.begin(), density.end(), 0 );
+    weight = 1.0;
+    scale = 0;
+    frameTimer.invalidate();
+    upload( 0, ROWS );
+    empty = true;
+}
+
+
+void SpectrumPersistence::upload( int firstRow, int rows ) {
+    gl->glBindTexture( GL_TEXTURE_2D, texture );
+    gl->glTexSubImage2D( GL_TEXTURE_2D, 0, 0, firstRow, COLUMNS, rows, GL_RED, GL_FLOAT,
+                         density.data() + size_t( firstRow * COLUMNS ) );
+    gl->glBindTexture( GL_TEXTURE_2D, 0 );
+}
+
+
+SpectrumPersistence::~SpectrumPersistence() {
+    if ( texture && QOpenGLContext::currentContext() )
+        gl->glDeleteTextures( 1, &texture );
+}
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QOpenGLFunctions>
+#include <QVector3D>
+#include <vector>
+
+#include "post/ppresult.h"
+
+/// \brief Spectrum persistence: density of the spectrum graphs of one channel over time (frequency x level).
+/// Each frame adds one hit per spectrum bin (or per map column if the bins are wider than a column) to a float
+/// density map that is shown as intensity graded texture, no old spectra are stored.
+/// The old hits decay exponentially, but instead of scaling the whole map each frame the weight of the new hits
+/// grows by 1 / decay and the shader scales the map with the inverse weight. So only the rows touched by the new
+/// spectrum are uploaded, the map is renormalized (and uploaded completely) only if the weight gets too large.
+struct SpectrumPersistence {
+    static const int COLUMNS = 1000; ///< horizontal resolution of the density map (DIVS_TIME)
+    static const int ROWS = 400;     ///< vertical resolution of the density map (DIVS_VOLTAGE)
+
+    explicit SpectrumPersistence( QOpenGLFunctions *gl );
+    SpectrumPersistence( const SpectrumPersistence & ) = delete;
+    SpectrumPersistence( SpectrumPersistence && ) = delete;
+    ~SpectrumPersistence();
+    /// \brief Add the hits of the new spectrum graph (screen coordinates in div).
+    /// \param graph The spectrum graph created by the GraphGenerator.
+    /// \param timeConstant The decay time constant in s.
+    void writeData( const ChannelGraph &graph, double timeConstant );
+    /// \brief Forget the old spectra if the frequency or level scale has changed.
+    void setGeometry( double frequencybase, double magnitude, double offset );
+    /// \brief Forget all old spectra.
+    void clear();
+
+    GLuint texture = 0; ///< the density map, one float per texel
+    GLfloat scale = 0;  ///< density * scale = 1.0 for a texel that is hit in each frame
+
+  private:
+    void upload( int firstRow, int rows );
+    QOpenGLFunctions *gl;
+    std::vector< GLfloat > density; ///< copy of the texture, ROWS x COLUMNS
+    std::vector< int > hits;        ///< map index of each hit of the current frame, -1 = off screen
+    double weight = 1.0;            ///< weight of a new hit
+    double frameInterval = 0.1;     ///< mean time between two frames in s
+    QVector3D geometry;             ///< frequencybase, magnitude and offset of the spectrum graphs
+    QElapsedTimer frameTimer;       ///< time since the previous frame
+    bool empty = true;              ///< no hits since the last clear()
+};
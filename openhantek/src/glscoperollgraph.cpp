@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include "glscoperollgraph.h"
+#include <algorithm>
+#include <stdexcept>
+
+RollGraph::RollGraph() : slotBuffer( QOpenGLBuffer::VertexBuffer ), valueBuffer( QOpenGLBuffer::VertexBuffer ) {
+    slotBuffer.create();
+    slotBuffer.setUsagePattern( QOpenGLBuffer::StaticDraw );
+    valueBuffer.create();
+    valueBuffer.setUsagePattern( QOpenGLBuffer::DynamicDraw );
+    if ( !vao.create() )
+        throw new std::runtime_error( "QOpenGLVertexArrayObject create failed" );
+}
+
+
+void RollGraph::writeData( const SampleValues &samples, int64_t rollTotal, QOpenGLShaderProgram *program,
+                           const RollAttributes &attributes ) {
+    const GLsizei count = GLsizei( samples.sample.size() );
+    if ( count != size || samples.interval != interval || total < 0 || rollTotal < total || rollTotal - total >= count ) {
+        // new geometry, restart or too many new samples -> upload the complete record
+        size = count;
+        offset = 0;
+        interval = samples.interval;
+        std::vector< GLfloat > slotNumbers( size_t( 4 * ( size + 1 ) ) );
+        for ( GLsizei slot = 0; slot <= size; ++slot ) {
+            slotNumbers[ size_t( 4 * slot ) ] = GLfloat( slot );
+            slotNumbers[ size_t( 4 * slot + 1 ) ] = -1;
+            slotNumbers[ size_t( 4 * slot + 2 ) ] = GLfloat( slot );
+            slotNumbers[ size_t( 4 * slot + 3 ) ] = 1;
+        }
+        values.assign( size_t( 2 * ( size + 1 ) + 4 ), 0 );
+        const int valueSize = int( sizeof( GLfloat ) );
+        program->bind();
+        vao.bind();
+        slotBuffer.bind();
+        slotBuffer.allocate( slotNumbers.data(), int( slotNumbers.size() * sizeof( GLfloat ) ) );
+        program->enableAttributeArray( attributes.slot );
+        program->setAttributeBuffer( attributes.slot, GL_FLOAT, 0, 2, 0 );
+        valueBuffer.bind();
+        valueBuffer.allocate( int( values.size() * sizeof( GLfloat ) ) );
+        program->enableAttributeArray( attributes.previous );
+        program->setAttributeBuffer( attributes.previous, GL_FLOAT, 0, 1, 0 );
+        program->enableAttributeArray( attributes.value );
+        program->setAttributeBuffer( attributes.value, GL_FLOAT, 2 * valueSize, 1, 0 );
+        program->enableAttributeArray( attributes.next );
+        program->setAttributeBuffer( attributes.next, GL_FLOAT, 4 * valueSize, 1, 0 );
+        vao.release();
+        writeValues( 0, samples.sample.data(), size );
+    } else if ( rollTotal > total ) {
+        // overwrite the oldest samples with the newest ones, only these are transferred to the GPU
+        const GLsizei newSamples = GLsizei( rollTotal - total );
+        const double *newest = samples.sample.data() + count - newSamples;
+        const GLsizei first = std::min( newSamples, size - offset ); // up to the end of the buffer
+        valueBuffer.bind();
+        writeValues( offset, newest, first );
+        if ( first < newSamples )
+            writeValues( 0, newest + first, newSamples - first ); // wrapped part
+        offset = ( offset + newSamples ) % size;
+    }
+    valueBuffer.release();
+    total = rollTotal;
+}
+
+
+// write valueBuffer at the slot position, keep the copy of slot 0 and the neighbours at both ends up to date
+void RollGraph::writeValues( GLsizei slot, const double *samples, GLsizei count ) {
+    if ( count <= 0 )
+        return;
+    for ( GLsizei index = 0; index < count; ++index ) // both sides of the line
+        values[ size_t( 2 + 2 * ( slot + index ) ) ] = values[ size_t( 3 + 2 * ( slot + index ) ) ] = GLfloat( samples[ index ] );
+    valueBuffer.bind();
+    writeRange( size_t( 2 + 2 * slot ), size_t( 2 * count ) );
+    const size_t copy = size_t( 2 + 2 * size ); // slot size = copy of slot 0
+    values[ copy ] = values[ copy + 1 ] = values[ 2 ];
+    values[ 0 ] = values[ 1 ] = values[ copy - 2 ];          // previous of slot 0 = slot size - 1
+    values[ copy + 2 ] = values[ copy + 3 ] = values[ 4 ]; // next of slot size = slot 1
+    writeRange( 0, 2 );
+    writeRange( copy, 4 );
+}
+
+
+void RollGraph::writeRange( size_t first, size_t count ) {
+    valueBuffer.write( int( first * sizeof( GLfloat ) ), values.data() + first, int( count * sizeof( GLfloat ) ) );
+}
+
+
+RollGraph::~RollGraph() {
+    vao.destroy();
+    if ( slotBuffer.isCreated() )
+        slotBuffer.destroy();
+    if ( valueBuffer.isCreated() )
+        valueBuffer.destroy();
+}
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <QOpenGLBuffer>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <vector>
+
+#include "post/ppresult.h"
+
+/// \brief Attribute locations of the roll mode line shader.
+/// `slot` = ( slot number, side of the line -1 / +1 ), `previous` and `next` are the neighbours of `value`,
+/// read from the same buffer with an offset of -/+ two values (see LineAttributes).
+struct RollAttributes {
+    int slot;
+    int value;
+    int previous;
+    int next;
+};
+
+/// \brief Circular GPU buffer for a roll mode trace.
+/// The new samples overwrite the oldest samples and the display scrolls by moving the
+/// offset uniform, the vertex shader maps the buffer slots to the screen positions.
+/// Slot `size` is a copy of slot 0 to close the line strip at the wrap position.
+/// Each slot is stored twice for both sides of the antialiased line (triangle strip).
+struct RollGraph {
+    explicit RollGraph();
+    RollGraph( const RollGraph & ) = delete;
+    RollGraph( const RollGraph && ) = delete;
+    ~RollGraph();
+    /// \brief Append the new samples, upload all samples if the record geometry has changed.
+    void writeData( const SampleValues &samples, int64_t rollTotal, QOpenGLShaderProgram *program,
+                    const RollAttributes &attributes );
+    /// \brief Upload everything with the next `writeData()`.
+    void invalidate() { total = -1; }
+
+  public:
+    bool active = false;       ///< the trace of this channel is drawn from this buffer
+    GLsizei size = 0;          ///< number of samples in the buffer
+    GLsizei offset = 0;        ///< slot of the oldest sample
+    int64_t total = -1;        ///< rollTotal of the last written sample
+    double interval = 0.0;     ///< time between two samples
+    QOpenGLBuffer slotBuffer;  ///< static ( slot number, side ) pairs for slot 0 .. size
+    QOpenGLBuffer valueBuffer; ///< sample values, written circularly
+    QOpenGLVertexArrayObject vao;
+
+  private:
+    void writeValues( GLsizei slot, const double *samples, GLsizei count );
+    void writeRange( size_t first, size_t count );
+    std::vector< GLfloat > values; ///< copy of valueBuffer: 2 neighbours, 2 * ( size + 1 ) values, 2 neighbours
+};
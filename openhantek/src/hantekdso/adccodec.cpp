@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <cstdint>
+#include <cstring>
+
+#include "adccodec.h"
+
+
+static const size_t HEADER_SIZE = 5; // sample count + channel count
+
+
+void adcEncode( const unsigned char *raw, size_t count, unsigned channels, std::vector< unsigned char > &encoded ) {
+    channels = channels ? channels : 1;
+    const size_t blocks = ( count + ADC_CODEC_BLOCK - 1 ) / ADC_CODEC_BLOCK;
+    encoded.resize( HEADER_SIZE + blocks * ( 1 + ADC_CODEC_BLOCK ) ); // worst case, shrinked at the end
+    unsigned char *out = encoded.data();
+    for ( unsigned byte = 0; byte < 4; ++byte )
+        *out++ = uint8_t( count >> ( 8 * byte ) );
+    *out++ = uint8_t( channels );
+
+    uint8_t zigzag[ ADC_CODEC_BLOCK ];
+    for ( size_t first = 0; first < count; first += ADC_CODEC_BLOCK ) {
+        const size_t length = count - first < ADC_CODEC_BLOCK ? count - first : ADC_CODEC_BLOCK;
+        const unsigned char *block = raw + first;
+        unsigned bits = 0;
+        size_t index = 0;
+        for ( ; index < length && first + index < channels; ++index ) { // start of the record, delta to 0x80
+            const int8_t delta = int8_t( block[ index ] - 0x80 );
+            zigzag[ index ] = uint8_t( uint8_t( delta ) << 1 ) ^ uint8_t( delta >> 7 ); // no shift of a negative value
+            bits |= zigzag[ index ];
+        }
+        for ( ; index < length; ++index ) { // no dependencies between the iterations, vectorised by the compiler
+            const int8_t delta = int8_t( block[ index ] - raw[ first + index - channels ] );
+            zigzag[ index ] = uint8_t( uint8_t( delta ) << 1 ) ^ uint8_t( delta >> 7 );
+            bits |= zigzag[ index ];
+        }
+        for ( ; index < ADC_CODEC_BLOCK; ++index ) // pad the last block
+            zigzag[ index ] = 0;
+        unsigned width = 0;
+        while ( bits >> width )
+            ++width;
+        *out++ = uint8_t( width );
+        if ( !width ) // constant signal
+            continue;
+        for ( unsigned group = 0; group < ADC_CODEC_BLOCK; group += 8 ) { // 8 deltas -> width bytes
+            uint64_t packed = 0;
+            for ( unsigned iii = 0; iii < 8; ++iii )
+                packed |= uint64_t( zigzag[ group + iii ] ) << ( iii * width );
+            for ( unsigned byte = 0; byte < width; ++byte )
+                *out++ = uint8_t( packed >> ( 8 * byte ) );
+        }
+    }
+    encoded.resize( size_t( out - encoded.data() ) );
+}
+
+
+bool adcDecode( const unsigned char *encoded, size_t size, std::vector< unsigned char > &raw, unsigned &channels ) {
+    raw.clear();
+    if ( size < HEADER_SIZE )
+        return false;
+    size_t count = 0;
+    for ( unsigned byte = 0; byte < 4; ++byte )
+        count |= size_t( encoded[ byte ] ) << ( 8 * byte );
+    channels = encoded[ 4 ];
+    if ( !channels || count > ( size - HEADER_SIZE ) * ADC_CODEC_BLOCK ) // each block needs at least one byte
+        return false;
+    const unsigned char *in = encoded + HEADER_SIZE;
+    const unsigned char *end = encoded + size;
+    raw.resize( count );
+
+    uint8_t zigzag[ ADC_CODEC_BLOCK ];
+    for ( size_t first = 0; first < count; first += ADC_CODEC_BLOCK ) {
+        if ( in >= end )
+            return false;
+        const unsigned width = *in++;
+        if ( width > 8 || size_t( end - in ) < 8 * width )
+            return false;
+        if ( !width ) {
+            memset( zigzag, 0, sizeof( zigzag ) );
+        } else {
+            const uint64_t mask = ( uint64_t( 1 ) << width ) - 1;
+            for ( unsigned group = 0; group < ADC_CODEC_BLOCK; group += 8 ) {
+                uint64_t packed = 0;
+                for ( unsigned byte = 0; byte < width; ++byte )
+                    packed |= uint64_t( *in++ ) << ( 8 * byte );
+                for ( unsigned iii = 0; iii < 8; ++iii )
+                    zigzag[ group + iii ] = uint8_t( ( packed >> ( iii * width ) ) & mask );
+            }
+        }
+        const size_t length = count - first < ADC_CODEC_BLOCK ? count - first : ADC_CODEC_BLOCK;
+        unsigned char *block = raw.data() + first;
+        for ( size_t index = 0; index < length; ++index ) {
+            const unsigned char previous = first + index >= channels ? raw.data()[ first + index - channels ] : 0x80;
+            const uint8_t delta = uint8_t( ( zigzag[ index ] >> 1 ) ^ -( zigzag[ index ] & 1 ) );
+            block[ index ] = uint8_t( previous + delta );
+        }
+    }
+    return true;
+}
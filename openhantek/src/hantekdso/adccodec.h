@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/// \brief Lossless compression of raw 8 bit ADC samples for recordings and retained frames.
+///
+/// The samples change slowly compared to the ADC resolution, so the differences to the previous sample
+/// of the same channel are small. These deltas are zigzag mapped (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...)
+/// and packed per block of `ADC_CODEC_BLOCK` deltas with the bit width of the largest delta in the block.
+/// The packing works on groups of 8 deltas (8 deltas with `width` bits = `width` bytes) without bit
+/// stream bookkeeping, i.e. a few simple operations per sample, fast enough for the full USB rate.
+///
+/// Format: 4 byte sample count (little endian), 1 byte channel count, then for each block:
+/// 1 byte bit width (0..8) and `8 * width` bytes packed deltas, the last block is padded with zero deltas.
+/// A constant signal needs 1 byte per block, noise of +/- 1 LSB 2 bits per sample, the worst case is
+/// 65 bytes per 64 samples.
+static const unsigned ADC_CODEC_BLOCK = 64;
+
+
+/// \brief Compress the interleaved raw samples.
+/// \param raw The raw samples, interleaved CH1/CH2/CH1/CH2 ... if `channels == 2`.
+/// \param count Number of raw bytes.
+/// \param channels Number of interleaved channels, the deltas are calculated per channel.
+/// \param encoded The compressed data, replaces the content.
+void adcEncode( const unsigned char *raw, size_t count, unsigned channels, std::vector< unsigned char > &encoded );
+
+
+/// \brief Restore the raw samples.
+/// \param encoded The compressed data created by `adcEncode()`.
+/// \param size Size of the compressed data.
+/// \param raw The raw samples, replaces the content.
+/// \param channels Number of interleaved channels (output).
+/// \return false if the compressed data is truncated or invalid.
+bool adcDecode( const unsigned char *encoded, size_t size, std::vector< unsigned char > &raw, unsigned &channels );
+
+
+/// \brief Raw recording: the compressed ADC samples of one frame and the data needed to convert them to volts.
+/// voltage = ( code - offset[ channel ] ) * factor[ channel ], averaged over `oversampling` ADC samples.
+struct RawFrame {
+    std::vector< unsigned char > encoded; ///< compressed interleaved ADC samples, empty = frame not recorded
+    double samplerate = 0.0;              ///< ADC samplerate (before oversampling)
+    unsigned oversampling = 1;            ///< ADC samples per displayed sample
+    double offset[ 2 ] = {0x80, 0x80};    ///< ADC code of 0 V for each channel
+    double factor[ 2 ] = {0.0, 0.0};      ///< volts per ADC step for each channel (probe and sign included)
+    int64_t requestTime = 0;              ///< ns, monotonic, the USB transfer of this frame was requested
+    int64_t completionTime = 0;           ///< ns, monotonic, the USB transfer was completed (end of the samples)
+};
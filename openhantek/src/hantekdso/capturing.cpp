@@ -5,10 +5,25 @@
 #include "capturing.h"
 #include "usb/scopedevice.h"
 #include <QDebug>
+#include <QElapsedTimer>
 #include <cmath>
 
 
-Capturing::Capturing( HantekDsoControl *hdc ) : hdc( hdc ) { hdc->capturing = true; }
+// adaptive chunk size for slow samplings, see Capturing::updateChunkLength()
+static const unsigned CHUNK_GRANULARITY = 512; // USB 2.0 bulk packet size
+static const unsigned CHUNK_MIN = 2 * CHUNK_GRANULARITY;
+static const unsigned CHUNK_MAX = 512 * 78 * 2; // ~2 s at the slowest rate, well below the USB timeout
+
+// continuous stream: the synchronous reads leave a pause between two frames that the FX2 FIFO must bridge,
+// an overflowing FIFO keeps the old samples and loses the newer ones, i.e. the frame would have a hidden gap
+static const double STREAM_FIFO_SIZE = 4 * 512; // bytes
+static const double STREAM_MAX_RATE = 1e6;      // bytes/s, half of the FIFO bridges 1 ms
+
+
+Capturing::Capturing( HantekDsoControl *hdc ) : hdc( hdc ) {
+    hdc->capturing = true;
+    frameClock.start();
+}
 
 
 void Capturing::run() {
@@ -21,9 +36,12 @@ void Capturing::run() {
         if ( hdc->scope ) { // device is initialized
             if ( hdc->sampling ) {
                 capture();
-                // add user defined hold-off time to lower CPU load
-                QThread::msleep( unsigned( 1000 * hdc->scope->horizontal.acquireInterval ) );
+                // add user defined hold-off time to lower CPU load, a running stream must be read without pause
+                if ( !streaming )
+                    QThread::msleep( unsigned( 1000 * hdc->scope->horizontal.acquireInterval ) );
             } else {
+                streaming = false; // the FIFO overflows while nobody reads, restart the stream
+                lastCompletion = -1; // a pause is no dead time
                 QThread::msleep( unsigned( hdc->displayInterval ) );
             }
         }
@@ -41,10 +59,38 @@ double id2sr( uint8_t timediv ) {
 }
 
 
-void Capturing::xferSamples() {
-    QWriteLocker locker( &hdc->raw.lock );
-    if ( !freeRun )
+// transfer the captured frame, if !wait the frame is dropped while the conversion is busy (keep the stream running)
+bool Capturing::xferSamples( bool wait ) {
+    if ( wait )
+        hdc->raw.lock.lockForWrite();
+    else if ( !hdc->raw.lock.tryLockForWrite() )
+        return false;
+    if ( freeRun ) {
+        // start rolling with an empty buffer after a restart or if the size has changed
+        if ( !hdc->raw.rollMode || hdc->raw.rollBuffer.size() != rawSamplesize ) {
+            hdc->raw.rollBuffer.resize( rawSamplesize, 2 * CHUNK_MAX );
+            hdc->raw.rollMode = true;
+        }
+    } else {
         swap( data, hdc->raw.data );
+    }
+    // the samples of this frame end with the completion of the transfer, the gap to the previous
+    // transferred frame was not observed (restart, settling, USB overhead or dropped frames)
+    // only the net samples are kept, the discarded settling samples and the packet rounding do not count
+    const unsigned keptSamples = freeRun ? received / qMax( channels, 1u ) : netSamples;
+    const double observed = valid && samplerate > 0 ? double( keptSamples ) / samplerate : 0;
+    double deadTime = 0;
+    if ( lastCompletion >= 0 ) {
+        const double period = ( completionTime - lastCompletion ) * 1e-9;
+        deadTime = qMax( 0.0, period - observed );
+        observedSum = 0.9 * observedSum + qMin( observed, period ); // ratio of the sums over the last ~10 frames
+        periodSum = 0.9 * periodSum + period;
+    }
+    lastCompletion = completionTime;
+    hdc->raw.requestTime = requestTime;
+    hdc->raw.completionTime = completionTime;
+    hdc->raw.deadTime = deadTime;
+    hdc->raw.dutyCycle = periodSum > 0 ? observedSum / periodSum : 1.0;
     hdc->raw.channels = channels;
     hdc->raw.samplerate = samplerate;
     hdc->raw.oversampling = oversampling;
@@ -53,19 +99,29 @@ void Capturing::xferSamples() {
     hdc->raw.gainIndex[ 0 ] = gainIndex[ 0 ];
     hdc->raw.gainIndex[ 1 ] = gainIndex[ 1 ];
     hdc->raw.freeRun = freeRun;
+    hdc->raw.settled = settled;
+    hdc->raw.streamStart = streamStart;
+    hdc->raw.detail = detail;
+    hdc->raw.spectrum = spectrum;
     hdc->raw.valid = valid;
     hdc->raw.tag = tag;
+    hdc->raw.lock.unlock();
+    return true;
 }
 
 
 void Capturing::capture() {
-    if ( !hdc->samplingStarted )
+    if ( !hdc->samplingStarted ) {
+        streaming = false;
         return;
+    }
     int errorCode;
+    bool settingsChanged = false;
     // Send all pending control commands
     ControlCommand *controlCommand = hdc->firstControlCommand;
     while ( controlCommand ) {
         if ( controlCommand->pending ) {
+            settingsChanged = true;
             switch ( int( controlCommand->code ) ) {
             case uint8_t( ControlCode::CONTROL_SETGAIN_CH1 ):
                 gainValue[ 0 ] = controlCommand->data()[ 0 ];
@@ -86,7 +142,7 @@ void Capturing::capture() {
                 break;
             case uint8_t( ControlCode::CONTROL_SETSAMPLERATE ):
                 samplerate = id2sr( controlCommand->data()[ 0 ] );
-                uint8_t sampleIndex = controlCommand->data()[ 1 ];
+                sampleIndex = controlCommand->data()[ 1 ];
                 oversampling = uint8_t( hdc->specification->fixedSampleRates[ sampleIndex ].oversampling );
                 effectiveSamplerate = hdc->specification->fixedSampleRates[ sampleIndex ].samplerate;
                 if ( !realSlow && effectiveSamplerate < 10e3 &&
@@ -133,57 +189,182 @@ void Capturing::capture() {
     }
     valid = true;
     freeRun = hdc->triggerModeNONE() && realSlow;
-    // sample step by step into the target if rollMode, else buffer and switch one big block
-    dp = freeRun ? &hdc->raw.data : &data;
-    rawSamplesize = hdc->grossSampleCount( hdc->getSamplesize() * oversampling ) * channels;
-    dp->resize( rawSamplesize, 0x80 );
-    if ( tag && freeRun ) // in free run mode transfer settings immediately
+    // dual timebase: every second frame is captured with the detail samplerate for the zoomed scope
+    const unsigned detailIndex = hdc->detailSampleIndex;
+    detail = !detail && !freeRun && !realSlow && detailIndex > sampleIndex && setDetailSamplerate( detailIndex );
+    if ( detail )
+        settingsChanged = true; // restart with settle discard
+    spectrum = !freeRun && hdc->spectrumSamplesize; // record length for span and RBW, see getSamplesize()
+    // continuous stream: keep the ADC running and cut the frames from the settled sample stream,
+    // restart and discard the settling samples only after a settings change or a transfer problem
+    netSamples = hdc->getSamplesize() * oversampling;
+    const bool continuous = !freeRun && hdc->scope->horizontal.continuousStream && samplerate * channels <= STREAM_MAX_RATE;
+    // the FIFO fills up since the completion of the last frame, restart if it may overflow before the next read
+    const double pause = ( frameClock.nsecsElapsed() - completionTime ) * 1e-9;
+    const bool bridged = pause * samplerate * channels < STREAM_FIFO_SIZE / 2;
+    settled = continuous && streaming && !settingsChanged && netSamples == streamSize && bridged;
+    if ( !settled ) // a frame of the new stream shall never continue a frame of the old one
+        ++streamPosition;
+    streamStart = continuous ? streamPosition : -1;
+    // sample step by step into the roll buffer if freeRun, else buffer and switch one big block
+    rawSamplesize = ( settled ? hdc->streamSampleCount( netSamples ) : hdc->grossSampleCount( netSamples ) ) * channels;
+    if ( !freeRun )
+        data.resize( rawSamplesize, 0x80 );
+    updateChunkLength();
+    if ( freeRun ) // in free run mode transfer settings immediately, also for the first frame
         xferSamples();
     ++tag;
+    const unsigned restartCount = hdc->restartCount;
+    requestTime = frameClock.nsecsElapsed();
     if ( hdc->scopeDevice->isRealHW() ) {
-        received = getRealSamples();
+        overrun = false;
+        received = freeRun ? getRollSamples() : getRealSamples( !settled );
+        if ( restartCount == hdc->restartCount ) // not stopped due to new settings
+            hdc->countTransfer( sampleIndex, overrun, received != rawSamplesize );
     } else {
         received = getDemoSamples();
     }
+    completionTime = frameClock.nsecsElapsed();
+    // the stream keeps on running only if this frame was complete and not interrupted by new settings
+    streaming = continuous && !overrun && received == rawSamplesize && restartCount == hdc->restartCount;
+    streamSize = netSamples;
+    streamPosition += received / qMax( channels, 1u ); // a dropped frame leaves a gap for the following frames
     if ( received != rawSamplesize ) {
         // qDebug() << "retval != rawSamplesize" << received << rawSamplesize;
-        auto end = dp->end();
-        for ( auto it = dp->begin(); it != end; ++it )
-            *it = 0x80; // fill with "zeros"
+        if ( freeRun ) {
+            QWriteLocker locker( &hdc->raw.lock );
+            hdc->raw.rollMode = false; // restart rolling with an empty buffer
+        } else {
+            for ( auto it = data.begin(); it != data.end(); ++it )
+                *it = 0x80; // fill with "zeros"
+        }
         valid = false;
-        hdc->raw.rollMode = false;
-    } else {
-        hdc->raw.rollMode = true; // one complete buffer available, start to roll
     }
-    if ( !freeRun ) // in normal capturing mode transfer after capturing one block
-        xferSamples();
+    // in normal capturing mode transfer after capturing one block, a dropped frame also restarts the stream
+    if ( !freeRun && !xferSamples( !streaming ) )
+        streaming = false;
 }
 
 
-unsigned Capturing::getRealSamples() {
-    int errorCode;
-    errorCode = hdc->scopeDevice->controlWrite( hdc->getCommand( ControlCode::CONTROL_STARTSAMPLING ) );
+// Switch to the detail samplerate for this frame only, the overview samplerate command
+// is resent with the other pending commands before the next frame.
+bool Capturing::setDetailSamplerate( unsigned detailIndex ) {
+    if ( detailIndex >= hdc->specification->fixedSampleRates.size() )
+        return false;
+    const FixedSampleRate &fixedSampleRate = hdc->specification->fixedSampleRates[ detailIndex ];
+    ControlSetSamplerate controlCommand;
+    controlCommand.setSamplerate( fixedSampleRate.id, uint8_t( detailIndex ) );
+    if ( hdc->scopeDevice->isRealHW() ) {
+        int errorCode = hdc->scopeDevice->controlWrite( &controlCommand );
+        if ( errorCode < 0 ) {
+            qWarning( "Sending detail samplerate failed: %s", libUsbErrorString( errorCode ).toLocal8Bit().data() );
+            return false;
+        }
+    }
+    samplerate = id2sr( fixedSampleRate.id );
+    sampleIndex = detailIndex;
+    oversampling = fixedSampleRate.oversampling;
+    effectiveSamplerate = fixedSampleRate.samplerate;
+    hdc->modifyCommand< ControlSetSamplerate >( ControlCode::CONTROL_SETSAMPLERATE ); // back to overview with next frame
+    return true;
+}
+
+
+// start = false: the stream is still running, just read the next frame
+unsigned Capturing::getRealSamples( bool start ) {
+    int errorCode = 0;
+    if ( start )
+        errorCode = hdc->scopeDevice->controlWrite( hdc->getCommand( ControlCode::CONTROL_STARTSAMPLING ) );
     if ( errorCode < 0 ) {
         qWarning() << "controlWrite: Getting sample data failed: " << libUsbErrorString( errorCode );
-        dp->clear();
+        data.clear();
         return 0;
     }
     // Save raw data to temporary buffer
     // timestampDebug( QString( "Request packet %1: %2 bytes" ).arg( tag ).arg( rawSamplesize ) );
     hdc->raw.received = 0;
-    int retval = hdc->scopeDevice->bulkReadMulti( dp->data(), rawSamplesize, realSlow, hdc->raw.received );
+    QElapsedTimer transferTime;
+    transferTime.start();
+    int retval = hdc->scopeDevice->bulkReadMulti( data.data(), rawSamplesize, realSlow ? chunkLength : 0, hdc->raw.received );
     if ( retval < 0 ) {
         if ( retval == LIBUSB_ERROR_NO_DEVICE )
             hdc->scopeDevice->disconnectFromDevice();
+        overrun = true;
         qWarning() << "bulkReadMulti: Getting sample data failed: " << libUsbErrorString( retval );
-        dp->clear();
+        data.clear();
         return 0;
     }
     // timestampDebug( QString( "Received packet %1: %2 bytes" ).arg( tag ).arg( retval ) );
+    if ( realSlow ) { // average over all chunks of this block
+        const unsigned chunks = ( unsigned( retval ) + chunkLength - 1 ) / chunkLength;
+        if ( chunks )
+            measureTransfer( unsigned( retval ) / chunks, transferTime.nsecsElapsed() / chunks );
+    }
     return unsigned( retval );
 }
 
 
+// free run: read chunk by chunk and publish each chunk in the roll buffer for the display
+unsigned Capturing::getRollSamples() {
+    int errorCode;
+    errorCode = hdc->scopeDevice->controlWrite( hdc->getCommand( ControlCode::CONTROL_STARTSAMPLING ) );
+    if ( errorCode < 0 ) {
+        qWarning() << "controlWrite: Getting sample data failed: " << libUsbErrorString( errorCode );
+        return 0;
+    }
+    RollBuffer &rollBuffer = hdc->raw.rollBuffer;
+    if ( !rollBuffer.size() )
+        return 0;
+    unsigned received = 0;
+    while ( received < rawSamplesize ) {
+        const unsigned length = qMin( rawSamplesize - received, chunkLength );
+        chunk.resize( length );
+        unsigned packetReceived = 0;
+        QElapsedTimer transferTime;
+        transferTime.start();
+        int retval = hdc->scopeDevice->bulkReadMulti( chunk.data(), length, length, packetReceived );
+        if ( retval < 0 ) {
+            if ( retval == LIBUSB_ERROR_NO_DEVICE )
+                hdc->scopeDevice->disconnectFromDevice();
+            overrun = true;
+            qWarning() << "bulkReadMulti: Getting sample data failed: " << libUsbErrorString( retval );
+            break;
+        }
+        rollBuffer.write( chunk.data(), packetReceived - packetReceived % channels ); // keep CH1/CH2 order
+        received += packetReceived;
+        if ( packetReceived < length ) // short packet or stopped
+            break;
+        measureTransfer( packetReceived, transferTime.nsecsElapsed() );
+        updateChunkLength(); // adapt the next chunk
+    }
+    return received;
+}
+
+
+// Slow samplings are read in chunks to show the data while it is still coming in.
+// Size the chunks to fill the time between two display updates, but not smaller than
+// 10 times the measured transfer overhead, otherwise the USB handling would dominate.
+void Capturing::updateChunkLength() {
+    const double bytesPerSecond = samplerate * channels;
+    if ( bytesPerSecond <= 0 )
+        return;
+    const double chunkTime = qMax( hdc->displayInterval / 1000.0, 10 * transferOverhead );
+    unsigned length = unsigned( qMin( bytesPerSecond * chunkTime, double( CHUNK_MAX ) ) );
+    length -= length % CHUNK_GRANULARITY; // full USB packets, even number -> keeps CH1/CH2 order
+    chunkLength = qBound( CHUNK_MIN, length, CHUNK_MAX );
+}
+
+
+// feedback for updateChunkLength(): the time a chunk transfer took in excess of the sampling time
+void Capturing::measureTransfer( unsigned length, qint64 nsecs ) {
+    const double bytesPerSecond = samplerate * channels;
+    if ( !length || bytesPerSecond <= 0 )
+        return;
+    const double overhead = qMax( 0.0, nsecs * 1e-9 - length / bytesPerSecond );
+    transferOverhead += ( overhead - transferOverhead ) / 8; // low pass, ignore single outliers
+}
+
+
 unsigned Capturing::getDemoSamples() {
     const uint8_t binaryOffset = 0x80; // ADC format: binary offset
     const int8_t V_zero = 0;           // ADC = 0V
@@ -208,38 +389,44 @@ unsigned Capturing::getDemoSamples() {
     // adapt demo samples for high sample rates >10 MS/s
     if ( samplerate > 10e6 )
         deltaT = int( round( deltaT * samplerate / 10e6 ) );
-    const unsigned packetLength = 512 * 78; // 50 blocks for one screen width of 20000
-    unsigned block = 0;
-    dp->resize( rawSamplesize, binaryOffset );
-    auto end = dp->end();
     unsigned packet = 0;
     // bool couplingAC1 = hdc->scope->coupling( 0, hdc->specification ) == Dso::Coupling::AC; // not yet used
     bool couplingAC2 = hdc->scope->coupling( 1, hdc->specification ) == Dso::Coupling::AC;
-    for ( auto it = dp->begin(); it != end; ++it ) {
-        if ( ++counter >= deltaT ) {
-            counter = 0;
-            if ( --ch1 < V_minus_2 ) {
-                ch1 = V_plus_2;
-                if ( couplingAC2 )
-                    ch2 = ch2 <= V_zero ? V_plus_1 : V_minus_1; // -1V <-> +1V
-                else
-                    ch2 = ch2 <= V_plus_1 ? V_plus_2 : V_zero; // 0V <-> 2V
+    while ( received < rawSamplesize ) {
+        // free run: write directly into the roll buffer, else into the block buffer
+        const unsigned length = qMin( rawSamplesize - received, chunkLength );
+        QElapsedTimer transferTime;
+        transferTime.start();
+        if ( freeRun )
+            chunk.resize( length );
+        unsigned char *it = freeRun ? chunk.data() : data.data() + received;
+        unsigned char *end = it + length;
+        for ( ; it < end; ++it ) {
+            if ( ++counter >= deltaT ) {
+                counter = 0;
+                if ( --ch1 < V_minus_2 ) {
+                    ch1 = V_plus_2;
+                    if ( couplingAC2 )
+                        ch2 = ch2 <= V_zero ? V_plus_1 : V_minus_1; // -1V <-> +1V
+                    else
+                        ch2 = ch2 <= V_plus_1 ? V_plus_2 : V_zero; // 0V <-> 2V
+                }
             }
+            *it = uint8_t( qBound( 0, ch1 * gain1 + binaryOffset, 0xFF ) ); // clip if outside 8bit range
+            if ( 2 == channels )
+                *++it = uint8_t( qBound( 0, ch2 * gain2 + binaryOffset, 0xFF ) ); // clip ..
         }
-        *it = uint8_t( qBound( 0, ch1 * gain1 + binaryOffset, 0xFF ) ); // clip if outside 8bit range
-        ++received;
-        if ( 2 == channels ) {
-            *++it = uint8_t( qBound( 0, ch2 * gain2 + binaryOffset, 0xFF ) ); // clip ..
-            ++received;
-        }
-        if ( ( block += channels ) >= packetLength ) {
-            ++packet;
-            block = 0;
+        received += length;
+        ++packet;
+        if ( freeRun )
+            hdc->raw.rollBuffer.write( chunk.data(), length );
+        else
             hdc->raw.received = received;
-            QThread::usleep( unsigned( 1e6 * packetLength / channels / samplerate ) );
-            if ( !hdc->capturing || hdc->scopeDevice->hasStopped() )
-                break;
-        }
+        QThread::usleep( unsigned( 1e6 * length / channels / samplerate ) );
+        if ( !hdc->capturing || hdc->scopeDevice->hasStopped() )
+            break;
+        measureTransfer( length, transferTime.nsecsElapsed() ); // mimic the real HW chunk handling
+        updateChunkLength();
     }
     // timestampDebug( QString( "Received dummy packet %1: %2 bytes" ).arg( packet ).arg( rawSamplesize ) );
     return received;
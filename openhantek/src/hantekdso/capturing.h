@@ -4,6 +4,8 @@
 
 #include "hantekdsocontrol.h"
 
+#include <QElapsedTimer>
+
 class Capturing : public QThread {
     Q_OBJECT
 
@@ -14,9 +16,13 @@ class Capturing : public QThread {
   private:
     void run() override;
     void capture();
-    unsigned getRealSamples();
+    unsigned getRealSamples( bool start );
+    unsigned getRollSamples();
     unsigned getDemoSamples();
-    void xferSamples();
+    bool xferSamples( bool wait = true );
+    bool setDetailSamplerate( unsigned detailIndex );
+    void updateChunkLength();
+    void measureTransfer( unsigned length, qint64 nsecs );
     // bool active = true;
     HantekDsoControl *hdc;
     unsigned channels = 0;
@@ -24,13 +30,31 @@ class Capturing : public QThread {
     bool realSlow = false;
     double samplerate = 0;
     unsigned oversampling = 0;
+    unsigned sampleIndex = 0; // index of the fixed samplerate
     unsigned rawSamplesize = 0;
+    unsigned netSamples = 0; // samples per channel of the frame without the settling samples
     unsigned received = 0;
     unsigned gainValue[ 2 ] = {0, 0}; // 1,2,5,10,..
     unsigned gainIndex[ 2 ] = {0, 0}; // index 0..7
     unsigned tag = 0;
     bool valid = true;
+    bool overrun = false; // USB transfer error
     bool freeRun = false;
+    bool streaming = false;      // continuous stream: the ADC is running and the samples are settled
+    bool settled = false;        // the current frame is cut from the settled stream
+    unsigned streamSize = 0;     // net sample count of the running stream
+    int64_t streamPosition = 0;  // continuous stream: raw samples per channel read so far, a restart leaves a gap
+    int64_t streamStart = -1;    // continuous stream: position of the first sample of the current frame, -1 = no stream
+    bool detail = false;         // dual timebase: the current frame uses the detail samplerate
+    bool spectrum = false;       // spectrum acquisition: record length for span and RBW, no trigger
+    QElapsedTimer frameClock;    // monotonic time base of the frame timestamps
+    int64_t requestTime = 0;     // ns, the transfer of the current frame was requested
+    int64_t completionTime = 0;  // ns, the transfer of the current frame was completed
+    int64_t lastCompletion = -1; // ns, completion of the last transferred frame, -1 = (re)started
+    double observedSum = 0;      // smoothed sum of the time spans covered by samples
+    double periodSum = 0;        // smoothed sum of the frame periods
     std::vector< unsigned char > data;
-    std::vector< unsigned char > *dp = &data;
+    std::vector< unsigned char > chunk; // free run: one USB chunk before it is copied into the roll buffer
+    unsigned chunkLength = 512 * 78; // slow data is read in chunks of this size, see updateChunkLength()
+    double transferOverhead = 0;     // smoothed USB transfer overhead per chunk in s
 };
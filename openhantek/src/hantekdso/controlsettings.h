@@ -5,6 +5,10 @@
 #include "enums.h"
 #include "hantekprotocol/controlStructs.h"
 #include "hantekprotocol/types.h"
+#include "utils/transferfunction.h"
+
+#include <atomic>
+#include <vector>
 
 namespace Hantek {
 struct CalibrationValues;
@@ -21,12 +25,23 @@ struct ControlSettingsSamplerateTarget {
     enum SamplerrateSet { Duration, Samplerrate } samplerateSet;
 };
 
+/// \brief USB transfer statistics for one entry of the fixed samplerates.
+/// Counted by the capturing thread, read by the state machine.
+struct ControlSamplerateStatistics {
+    std::atomic< unsigned > frames{0};         ///< Number of captured frames
+    std::atomic< unsigned > overruns{0};       ///< Frames with USB transfer errors (overrun, timeout)
+    std::atomic< unsigned > shortTransfers{0}; ///< Frames with less samples than requested
+    unsigned failuresInRow = 0;                ///< Consecutive overruns or short transfers (capturing thread only)
+    std::atomic< bool > unstable{false};       ///< Avoid this samplerate (optional fallback policy)
+};
+
 /// \brief Stores the current samplerate settings of the device.
 struct ControlSettingsSamplerate {
-    ControlSettingsSamplerateTarget target; ///< The target samplerate values
-    const ControlSamplerateLimits *limits;  ///< The samplerate limits
-    unsigned int downsampler = 1;           ///< The variable downsampling factor
-    double current = 1e6;                   ///< The current samplerate
+    ControlSettingsSamplerateTarget target;                ///< The target samplerate values
+    const ControlSamplerateLimits *limits;                 ///< The samplerate limits
+    unsigned int downsampler = 1;                          ///< The variable downsampling factor
+    double current = 1e6;                                  ///< The current samplerate
+    std::vector< ControlSamplerateStatistics > statistics; ///< Transfer statistics for each fixed samplerate
 };
 
 /// \brief Stores the current trigger settings of the device.
@@ -48,6 +63,7 @@ struct ControlSettingsVoltage {
     bool inverted = false;                      ///< true, if the channel is inverted
     double probeAttn = 1.0;                     ///< attenuation of probe
     Dso::Coupling coupling = Dso::Coupling::DC; ///< The coupling
+    TransferFunction sensor;                    ///< Sensor transfer function, maps V to the sensor unit
 };
 
 /// \brief Stores the current settings of the device.
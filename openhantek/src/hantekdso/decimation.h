@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <cstdint>
+
+
+/// \brief Convert the raw ADC samples of one channel, average `oversampling` samples into one result sample.
+///
+/// The template parameters fix the loop bounds at compile time, so that the compiler can unroll and vectorise
+/// the inner loop; `CHANNELS = 0` or `OVERSAMPLING = 0` use the runtime arguments instead (generic fallback).
+/// \param raw First raw sample of this channel, interleaved CH1/CH2/CH1/CH2 ... if `channels == 2`.
+/// \param out The result samples.
+/// \param count Number of result samples, the raw span must hold `count * channels * oversampling` bytes.
+/// \param offset ADC value for 0V.
+/// \param factor Scale from ADC steps to Volt.
+/// \return true if at least one raw sample was clipped (0x00 or 0xFF).
+template < unsigned CHANNELS, unsigned OVERSAMPLING >
+bool decimateSamples( const unsigned char *raw, double *out, unsigned count, double offset, double factor,
+                      unsigned channels = CHANNELS, unsigned oversampling = OVERSAMPLING ) {
+    const unsigned ch = CHANNELS ? CHANNELS : channels;
+    const unsigned os = OVERSAMPLING ? OVERSAMPLING : oversampling;
+    const double scale = factor / os;
+    const double shift = offset * factor;
+    unsigned clipped = 0;
+    for ( unsigned index = 0; index < count; ++index, raw += ch * os ) {
+        unsigned sum = 0; // max. 200 * 255, no overflow
+        for ( unsigned iii = 0; iii < os; ++iii ) {
+            const unsigned rawSample = raw[ iii * ch ];
+            sum += rawSample;
+            clipped |= unsigned( uint8_t( rawSample + 1 ) < 2 ); // 0x00 or 0xFF -> clipped, without branch
+        }
+        out[ index ] = sum * scale - shift;
+    }
+    return clipped;
+}
+
+
+/// \brief The kernel signature used by `decimationKernel()`.
+typedef bool ( *DecimationKernel )( const unsigned char *raw, double *out, unsigned count, double offset, double factor,
+                                    unsigned channels, unsigned oversampling );
+
+
+/// \brief Select the specialised kernel for the oversampling values of `fixedSampleRates`.
+template < unsigned CHANNELS > DecimationKernel decimationKernel( unsigned oversampling ) {
+    switch ( oversampling ) {
+    case 1:
+        return decimateSamples< CHANNELS, 1 >;
+    case 2:
+        return decimateSamples< CHANNELS, 2 >;
+    case 5:
+        return decimateSamples< CHANNELS, 5 >;
+    case 10:
+        return decimateSamples< CHANNELS, 10 >;
+    case 20:
+        return decimateSamples< CHANNELS, 20 >;
+    case 50:
+        return decimateSamples< CHANNELS, 50 >;
+    case 100:
+        return decimateSamples< CHANNELS, 100 >;
+    case 200:
+        return decimateSamples< CHANNELS, 200 >;
+    default:
+        return decimateSamples< CHANNELS, 0 >;
+    }
+}
+
+
+/// \brief Select the specialised kernel for the (channels, oversampling) pair.
+inline DecimationKernel decimationKernel( unsigned channels, unsigned oversampling ) {
+    if ( 1 == channels )
+        return decimationKernel< 1 >( oversampling );
+    if ( 2 == channels )
+        return decimationKernel< 2 >( oversampling );
+    return decimateSamples< 0, 0 >;
+}
+
+
+/// \brief Convert the raw ADC samples of one channel with a lookup table, average `oversampling` values into one result.
+///
+/// Used for channels with a (nonlinear) sensor transfer function, the table holds the value for each of the 256 ADC codes
+/// with gain, offset, calibration, probe and sensor already applied, i.e. the conversion costs one lookup per raw sample.
+/// \param raw First raw sample of this channel, interleaved CH1/CH2/CH1/CH2 ... if `channels == 2`.
+/// \param out The result samples.
+/// \param count Number of result samples, the raw span must hold `count * channels * oversampling` bytes.
+/// \param table The value of each ADC code.
+/// \return true if at least one raw sample was clipped (0x00 or 0xFF).
+template < unsigned CHANNELS >
+bool decimateTableSamples( const unsigned char *raw, double *out, unsigned count, const double *table, unsigned oversampling,
+                           unsigned channels = CHANNELS ) {
+    const unsigned ch = CHANNELS ? CHANNELS : channels;
+    const double scale = 1.0 / oversampling;
+    unsigned clipped = 0;
+    for ( unsigned index = 0; index < count; ++index, raw += ch * oversampling ) {
+        double sum = 0;
+        for ( unsigned iii = 0; iii < oversampling; ++iii ) {
+            const unsigned rawSample = raw[ iii * ch ];
+            sum += table[ rawSample ];
+            clipped |= unsigned( uint8_t( rawSample + 1 ) < 2 );
+        }
+        out[ index ] = sum * scale;
+    }
+    return clipped;
+}
+
+
+/// \brief Convert with lookup table, select the kernel for the channel count.
+inline bool decimateTable( const unsigned char *raw, double *out, unsigned count, const double *table, unsigned channels,
+                           unsigned oversampling ) {
+    if ( 1 == channels )
+        return decimateTableSamples< 1 >( raw, out, count, table, oversampling );
+    if ( 2 == channels )
+        return decimateTableSamples< 2 >( raw, out, count, table, oversampling );
+    return decimateTableSamples< 0 >( raw, out, count, table, oversampling, channels );
+}
@@ -5,17 +5,35 @@
 #include <QReadLocker>
 #include <QReadWriteLock>
 #include <QWriteLocker>
+#include <cstdint>
 #include <vector>
 
+#include "adccodec.h"
+
 struct DSOsamples {
     std::vector< std::vector< double > > data; ///< Pointer to input data from device
     double samplerate = 0.0;                   ///< The samplerate of the input data
     unsigned char clipped = 0;                 ///< Bitmask of clipped channels
+    double inputPeak[ 2 ] = {-1, -1};          ///< autorange: peak input voltage from the ADC codes, -1 = not measured
     bool liveTrigger = false;                  ///< live samples are triggered
     unsigned triggeredPosition = 0;            ///< position for a triggered trace, 0 = not triggered
     double pulseWidth1 = 0.0;                  ///< width from trigger point to next opposite slope
     double pulseWidth2 = 0.0;                  ///< width from next opposite slope to third slope
     bool freeRunning = false;                  ///< trigger: NONE, half sample count
     unsigned tag = 0;                          ///< track individual sample blocks (debug support)
+    int64_t rollTotal = -1;                    ///< roll mode: stream count after the last sample, -1 = not rolling
+    int64_t streamStart = -1;                  ///< continuous stream: raw position of the first sample, -1 = no stream
+    int64_t streamEnd = -1;                    ///< continuous stream: raw position after the last sample
+    bool detail = false;                       ///< dual timebase: detail frame for the zoomed scope
+    bool hasDetail = false;                    ///< dual timebase: detail frames are interleaved with the overview
+    bool spectrumOnly = false;                 ///< spectrum acquisition: record for span and RBW, no time domain
+    int64_t requestTime = 0;                   ///< ns, monotonic, the USB transfer of this frame was requested
+    int64_t completionTime = 0;                ///< ns, monotonic, the USB transfer was completed (end of the samples)
+    double deadTime = 0.0;                     ///< s, gap without samples between the previous frame and this frame
+    double dutyCycle = 1.0;                    ///< smoothed ratio of observed time to total time
+    unsigned roiFirst = 0;                     ///< ROI mode: first sample of the displayed window plus margins
+    unsigned roiCount = 0;                     ///< ROI mode: number of samples in the ROI, 0 = whole record
+    bool roiSpectrumRecord = false;            ///< ROI mode: the spectrum needs the whole record
+    RawFrame rawFrame;                         ///< raw recording: compressed ADC samples of the converted part
     mutable QReadWriteLock lock;
 };
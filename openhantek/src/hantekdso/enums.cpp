@@ -6,6 +6,7 @@
 namespace Dso {
 Enum< Dso::TriggerMode, Dso::TriggerMode::ROLL, Dso::TriggerMode::SINGLE > TriggerModeEnum;
 Enum< Dso::Slope, Dso::Slope::Positive, Dso::Slope::Both > SlopeEnum;
+Enum< Dso::SerialProtocol, Dso::SerialProtocol::OFF, Dso::SerialProtocol::I2C > SerialProtocolEnum;
 Enum< Dso::GraphFormat, Dso::GraphFormat::TY, Dso::GraphFormat::XY > GraphFormatEnum;
 
 /// \brief Return string representation of the given graph format.
@@ -78,4 +79,21 @@ QString slopeString( Slope slope ) {
     return QString();
 }
 
+/// \brief Return string representation of the given serial trigger protocol.
+/// \param protocol The ::SerialProtocol that should be returned as string.
+/// \return The string that should be used in labels etc.
+QString serialProtocolString( SerialProtocol protocol ) {
+    switch ( protocol ) {
+    case SerialProtocol::OFF:
+        return QCoreApplication::tr( "Slope" );
+    case SerialProtocol::UART:
+        return QCoreApplication::tr( "UART" );
+    case SerialProtocol::SPI:
+        return QCoreApplication::tr( "SPI" );
+    case SerialProtocol::I2C:
+        return QCoreApplication::tr( "I2C" );
+    }
+    return QString();
+}
+
 } // namespace Dso
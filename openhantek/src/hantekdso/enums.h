@@ -49,6 +49,16 @@ enum class Slope : uint8_t {
 };
 extern Enum< Dso::Slope, Dso::Slope::Positive, Dso::Slope::Both > SlopeEnum;
 
+/// \enum SerialProtocol
+/// \brief The serial bus that is decoded for the serial content trigger.
+enum class SerialProtocol {
+    OFF,  ///< Trigger on the slope
+    UART, ///< 8N1, LSB first, data on the trigger source channel
+    SPI,  ///< Mode 0, MSB first, CH1 = clock, CH2 = data
+    I2C   ///< CH1 = SCL, CH2 = SDA
+};
+extern Enum< Dso::SerialProtocol, Dso::SerialProtocol::OFF, Dso::SerialProtocol::I2C > SerialProtocolEnum;
+
 /// \enum InterpolationMode
 /// \brief The different interpolation modes for the graphs.
 enum InterpolationMode {
@@ -64,11 +74,13 @@ QString graphFormatString( GraphFormat format );
 QString couplingString( Coupling coupling );
 QString triggerModeString( TriggerMode mode );
 QString slopeString( Slope slope );
+QString serialProtocolString( SerialProtocol protocol );
 // QString interpolationModeString(InterpolationMode interpolation);
 } // namespace Dso
 
 Q_DECLARE_METATYPE( Dso::TriggerMode )
 Q_DECLARE_METATYPE( Dso::Slope )
+Q_DECLARE_METATYPE( Dso::SerialProtocol )
 Q_DECLARE_METATYPE( Dso::Coupling )
 Q_DECLARE_METATYPE( Dso::GraphFormat )
 Q_DECLARE_METATYPE( Dso::ChannelMode )
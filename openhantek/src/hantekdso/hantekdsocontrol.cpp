@@ -15,6 +15,7 @@
 
 #include <stdio.h>
 
+#include "decimation.h"
 #include "hantekdsocontrol.h"
 #include "hantekprotocol/controlStructs.h"
 #include "scopesettings.h"
@@ -23,6 +24,13 @@
 using namespace Hantek;
 using namespace Dso;
 
+// Spectrum acquisition: FFT length limit and raw record limit (same as 20000 samples with 200x oversampling)
+static const unsigned SPECTRUM_SAMPLES_MAX = 1000000;
+static const unsigned SPECTRUM_RAW_MAX = HantekDsoControl::SAMPLESIZE * 200;
+
+// ROI mode: samples kept on both sides of the displayed window (sinc interpolation, smoothing, trigger context)
+static const unsigned ROI_MARGIN = 100;
+
 
 HantekDsoControl::HantekDsoControl( ScopeDevice *device, const DSOModel *model )
     : scopeDevice( device ), model( model ), specification( model->spec() ),
@@ -31,6 +39,10 @@ HantekDsoControl::HantekDsoControl( ScopeDevice *device, const DSOModel *model )
 
     if ( device && specification->fixedUSBinLength )
         device->overwriteInPacketLength( unsigned( specification->fixedUSBinLength ) );
+    // the atomic counters are not movable, i.e. the vector cannot grow with resize()
+    std::vector< Dso::ControlSamplerateStatistics >( specification->fixedSampleRates.size() )
+        .swap( controlsettings.samplerate.statistics );
+    sensorTables.resize( specification->channels );
     // Apply special requirements by the devices model
     model->applyRequirements( this );
     retrieveChannelLevelData();
@@ -66,9 +78,10 @@ void HantekDsoControl::updateSamplerateLimits() {
     if ( controlsettings.samplerate.current > limit ) {
         setSamplerate( limit );
     }
-    for ( auto &v : specification->fixedSampleRates ) {
-        if ( v.samplerate <= limit ) {
-            sampleSteps << v.samplerate;
+    for ( unsigned sampleIndex = 0; sampleIndex < specification->fixedSampleRates.size(); ++sampleIndex ) {
+        const double samplerate = specification->fixedSampleRates[ sampleIndex ].samplerate;
+        if ( samplerate <= limit && isStable( sampleIndex ) ) {
+            sampleSteps << samplerate;
         }
     }
     // qDebug() << "HDC::updateSamplerateLimits " << sampleSteps;
@@ -98,12 +111,19 @@ Dso::ErrorCode HantekDsoControl::setSamplerate( double samplerate ) {
         controlsettings.samplerate.target.samplerate = samplerate;
         controlsettings.samplerate.target.samplerateSet = ControlSettingsSamplerateTarget::Samplerrate;
     }
+    if ( spectrumSamplesize ) // keep the target, spectrum acquisition selects the samplerate
+        return Dso::ErrorCode::NONE;
     uint8_t sampleIndex;
     for ( sampleIndex = 0; sampleIndex < specification->fixedSampleRates.size() - 1; ++sampleIndex ) {
         if ( long( round( specification->fixedSampleRates[ sampleIndex ].samplerate ) ) ==
              long( round( samplerate ) ) ) // dont compare double == double
             break;
     }
+    if ( !isStable( sampleIndex ) ) { // use the next lower stable samplerate
+        while ( sampleIndex > 0 && !isStable( sampleIndex ) )
+            --sampleIndex;
+        samplerate = specification->fixedSampleRates[ sampleIndex ].samplerate;
+    }
     controlSetSamplerate( sampleIndex );
     setDownsampling( specification->fixedSampleRates[ sampleIndex ].oversampling );
     controlsettings.samplerate.current = samplerate;
@@ -125,6 +145,8 @@ Dso::ErrorCode HantekDsoControl::setRecordTime( double duration ) {
         controlsettings.samplerate.target.duration = duration;
         controlsettings.samplerate.target.samplerateSet = ControlSettingsSamplerateTarget::Duration;
     }
+    if ( spectrumSamplesize ) // keep the target, spectrum acquisition selects the samplerate
+        return Dso::ErrorCode::NONE;
     // printf( "duration = %g\n", duration );
 
     double srLimit;
@@ -140,7 +162,7 @@ Dso::ErrorCode HantekDsoControl::setRecordTime( double duration ) {
         // qDebug() << "sampleIndex:" << sampleIndex << "sRate:" << sRate << "sRate*duration:" << sRate * duration;
         // Ensure that at least 1/2 of remaining samples are available for SW trigger algorithm
         // for stability reason avoid the highest sample rate as default
-        if ( sRate < srLimit && sRate * duration <= SAMPLESIZE / 2 ) {
+        if ( sRate < srLimit && sRate * duration <= SAMPLESIZE / 2 && isStable( iii ) ) {
             sampleIndex = iii;
         }
     }
@@ -258,6 +280,18 @@ Dso::ErrorCode HantekDsoControl::setProbe( ChannelID channel, double probeAttn )
 }
 
 
+Dso::ErrorCode HantekDsoControl::setSensor( ChannelID channel, const TransferFunction &sensor ) {
+    if ( channel >= specification->channels )
+        return Dso::ErrorCode::PARAMETER;
+    if ( sensor == controlsettings.voltage[ channel ].sensor )
+        return Dso::ErrorCode::NONE;
+    QWriteLocker locker( &raw.lock ); // the conversion uses the transfer function while holding raw.lock
+    controlsettings.voltage[ channel ].sensor = sensor;
+    sensorTables[ channel ].valid = false;
+    return Dso::ErrorCode::NONE;
+}
+
+
 Dso::ErrorCode HantekDsoControl::setCoupling( ChannelID channel, Dso::Coupling coupling ) {
     if ( deviceNotConnected() )
         return Dso::ErrorCode::CONNECTION;
@@ -294,6 +328,7 @@ Dso::ErrorCode HantekDsoControl::setTriggerMode( Dso::TriggerMode mode ) {
     }
     lastMode = mode;
     newTriggerParam = true;
+    updateSpectrumAcquisition(); // not in roll mode
     return Dso::ErrorCode::NONE;
 }
 
@@ -353,13 +388,144 @@ Dso::ErrorCode HantekDsoControl::setTriggerOffset( double position ) {
 }
 
 
+Dso::ErrorCode HantekDsoControl::setSerialTrigger( Dso::SerialProtocol protocol, const QString &pattern, unsigned baudrate ) {
+    QWriteLocker locker( &result.lock ); // the trigger search uses the automaton while holding result.lock
+    const bool ok = serialTrigger.setup( protocol, pattern, baudrate );
+    newTriggerParam = true;
+    if ( !ok ) {
+        emit statusMessage( tr( "Invalid serial trigger pattern '%1'" ).arg( pattern ), 0 );
+        return Dso::ErrorCode::PARAMETER;
+    }
+    return Dso::ErrorCode::NONE;
+}
+
+
+// Dual timebase: the detail frames are captured alternately with the highest samplerate that holds
+// the zoomed window (and the trigger point) in half of the record, the other half is left for the trigger search.
+void HantekDsoControl::updateDetailTimebase() {
+    unsigned index = 0;
+    if ( dualTimebase && !spectrumSamplesize && scope && scope->horizontal.format == Dso::GraphFormat::TY &&
+         !triggerModeNONE() && controlsettings.trigger.mode != Dso::TriggerMode::SINGLE ) {
+        const double timebase = controlsettings.samplerate.target.duration / DIVS_TIME;
+        const double trigger = controlsettings.trigger.position * DIVS_TIME + MARGIN_LEFT; // screen position in div
+        const double zoomLeft = qMin( scope->getMarker( 0 ), scope->getMarker( 1 ) );
+        const double zoomRight = qMax( scope->getMarker( 0 ), scope->getMarker( 1 ) );
+        const double pre = qMax( trigger - zoomLeft, 0.0 ) * timebase; // the record must contain the trigger point
+        const double post = qMax( zoomRight - trigger, 0.0 ) * timebase;
+        const double limit = isSingleChannel() ? specification->samplerate.single.max : specification->samplerate.multi.max;
+        for ( unsigned iii = 0; iii < specification->fixedSampleRates.size(); ++iii ) {
+            const double samplerate = specification->fixedSampleRates[ iii ].samplerate;
+            if ( samplerate > controlsettings.samplerate.current && samplerate <= limit &&
+                 samplerate * ( pre + post ) <= SAMPLESIZE / 2 && isStable( iii ) )
+                index = iii;
+        }
+        if ( index && pre + post > 0 ) {
+            detailDuration = pre + post;
+            detailPosition = pre / detailDuration;
+        } else {
+            index = 0;
+        }
+    }
+    detailSampleIndex = index;
+}
+
+
+// ROI mode: the post processing (copy, math, measurements and optionally the spectrum) handles only
+// the samples of the displayed window, selected with the same rule as GraphGenerator::generateGraphsTYvoltage().
+// Roll, XY, detail and spectrum acquisition frames are processed completely.
+void HantekDsoControl::updateRegionOfInterest() {
+    result.roiFirst = 0;
+    result.roiCount = 0; // whole record
+    result.roiSpectrumRecord = false;
+    if ( !scope || !scope->horizontal.roi || scope->horizontal.format != Dso::GraphFormat::TY || result.rollTotal >= 0 ||
+         result.detail || result.spectrumOnly || result.samplerate <= 0 )
+        return;
+    size_t sampleCount = 0;
+    for ( const std::vector< double > &samples : result.data )
+        sampleCount = qMax( sampleCount, samples.size() );
+    const int64_t dotsOnScreen = int64_t( ceil( displayDuration() * result.samplerate ) ) + 1;
+    const int64_t margin = ROI_MARGIN + dotsOnScreen / 8;
+    int64_t left = result.triggeredPosition; // start from sample[ 0 ] if not triggered
+    if ( left )
+        left -= int64_t( displayPosition() * ( dotsOnScreen - 1 ) ) + 1;
+    // fixed length, the window is shifted into the record, i.e. the ROI spectrum keeps its FFT length and bin width
+    const int64_t length = dotsOnScreen + 2 * margin;
+    if ( length >= int64_t( sampleCount ) ) // nothing to save
+        return;
+    const int64_t first = qBound( int64_t( 0 ), left - margin, int64_t( sampleCount ) - length );
+    result.roiFirst = unsigned( first );
+    result.roiCount = unsigned( length );
+    bool spectrumUsed = false;
+    for ( ChannelID channel = 0; channel < scope->spectrum.size(); ++channel )
+        spectrumUsed |= scope->spectrum[ channel ].used;
+    result.roiSpectrumRecord = spectrumUsed && !scope->horizontal.roiSpectrum; // the spectrum uses the whole record
+}
+
+
+Dso::ErrorCode HantekDsoControl::setSpectrumAcquisition( bool enabled, double span, double rbw ) {
+    if ( deviceNotConnected() )
+        return Dso::ErrorCode::CONNECTION;
+    if ( span <= 0 || rbw <= 0 )
+        return Dso::ErrorCode::PARAMETER;
+    spectrumAcquisition = enabled;
+    spectrumSpan = span;
+    spectrumRbw = rbw;
+    updateSpectrumAcquisition();
+    return Dso::ErrorCode::NONE;
+}
+
+
+// Spectrum acquisition: the lowest samplerate that covers the span (Nyquist) and the shortest record
+// that resolves the RBW (bin width = samplerate / record length) give the smallest USB and FFT load.
+void HantekDsoControl::updateSpectrumAcquisition() {
+    bool active = spectrumAcquisition && scope && scope->horizontal.format == Dso::GraphFormat::TY && !triggerModeNONE();
+    bool spectrumUsed = false;
+    for ( ChannelID channel = 0; active && channel < scope->voltage.size(); ++channel ) {
+        active = !scope->voltage[ channel ].used; // time domain graphs need the normal acquisition
+        spectrumUsed |= scope->spectrum[ channel ].used;
+    }
+    if ( !active || !spectrumUsed ) {
+        if ( spectrumSamplesize ) { // back to the samplerate or record time of the horizontal dock
+            spectrumSamplesize = 0;
+            restoreTargets();
+        }
+        return;
+    }
+    const double limit = isSingleChannel() ? specification->samplerate.single.max : specification->samplerate.multi.max;
+    unsigned sampleIndex = 0;
+    for ( unsigned iii = 0; iii < specification->fixedSampleRates.size(); ++iii ) {
+        const double samplerate = specification->fixedSampleRates[ iii ].samplerate;
+        if ( samplerate <= limit && isStable( iii ) ) {
+            sampleIndex = iii;                    // highest possible samplerate if the span is too wide
+            if ( samplerate >= 2 * spectrumSpan ) // smallest samplerate that covers the span
+                break;
+        }
+    }
+    const FixedSampleRate &fixedSampleRate = specification->fixedSampleRates[ sampleIndex ];
+    const double samplerate = fixedSampleRate.samplerate;
+    // multiple of 1000 samples (see netSampleCount()), bounded by FFT length and raw record size
+    const unsigned maxSamples = qMin( SPECTRUM_SAMPLES_MAX, SPECTRUM_RAW_MAX / fixedSampleRate.oversampling / 1000 * 1000 );
+    const unsigned samples = unsigned( qMin( ceil( samplerate / spectrumRbw / 1000 ), 1e6 ) ) * 1000;
+    const unsigned samplesize = qBound( 1000u, samples, maxSamples );
+    if ( samplesize == spectrumSamplesize && sampleIndex == spectrumSampleIndex ) // unchanged, keep the stream running
+        return;
+    spectrumSamplesize = samplesize;
+    spectrumSampleIndex = sampleIndex;
+    controlSetSamplerate( uint8_t( sampleIndex ) );
+    setDownsampling( fixedSampleRate.oversampling );
+    controlsettings.samplerate.current = samplerate;
+    emit samplerateChanged( samplerate );
+}
+
+
 // Initialize the device with the current settings.
 void HantekDsoControl::applySettings( DsoSettingsScope *dsoSettingsScope ) {
     scope = dsoSettingsScope;
     bool mathUsed = dsoSettingsScope->anyUsed( specification->channels );
     for ( ChannelID channel = 0; channel < specification->channels; ++channel ) {
         setProbe( channel, dsoSettingsScope->voltage[ channel ].probeAttn );
-        setGain( channel, dsoSettingsScope->gain( channel ) );
+        setSensor( channel, dsoSettingsScope->voltage[ channel ].sensor );
+        setGain( channel, dsoSettingsScope->voltageGain( channel ) );
         setTriggerLevel( channel, dsoSettingsScope->voltage[ channel ].trigger );
         setChannelUsed( channel, mathUsed | dsoSettingsScope->anyUsed( channel ) );
         setChannelInverted( channel, dsoSettingsScope->voltage[ channel ].inverted );
@@ -373,13 +539,86 @@ void HantekDsoControl::applySettings( DsoSettingsScope *dsoSettingsScope ) {
     setTriggerSlope( dsoSettingsScope->trigger.slope );
     setTriggerSource( dsoSettingsScope->trigger.source );
     setTriggerSmooth( dsoSettingsScope->trigger.smooth );
+    setSerialTrigger( dsoSettingsScope->trigger.serialProtocol, dsoSettingsScope->trigger.serialPattern,
+                      dsoSettingsScope->trigger.baudrate );
+    setSpectrumAcquisition( dsoSettingsScope->horizontal.spectrumAcquisition, dsoSettingsScope->horizontal.span,
+                            dsoSettingsScope->horizontal.rbw );
 }
 
 
 /// \brief Starts a new sampling block.
 void HantekDsoControl::restartSampling() {
     scopeDevice->stopSampling();
-    raw.rollMode = false;
+    {
+        QWriteLocker locker( &raw.lock ); // rollMode is checked by the capturing thread
+        raw.rollMode = false;
+    }
+    ++restartCount;
+}
+
+
+bool HantekDsoControl::isStable( unsigned sampleIndex ) const {
+    if ( !scope || !scope->horizontal.samplerateFallback || sampleIndex >= controlsettings.samplerate.statistics.size() )
+        return true;
+    return !controlsettings.samplerate.statistics[ sampleIndex ].unstable;
+}
+
+
+void HantekDsoControl::countTransfer( unsigned sampleIndex, bool overrun, bool shortTransfer ) {
+    if ( sampleIndex >= controlsettings.samplerate.statistics.size() )
+        return;
+    Dso::ControlSamplerateStatistics &statistics = controlsettings.samplerate.statistics[ sampleIndex ];
+    ++statistics.frames;
+    if ( overrun )
+        ++statistics.overruns;
+    else if ( shortTransfer )
+        ++statistics.shortTransfers;
+    if ( !overrun && !shortTransfer ) {
+        statistics.failuresInRow = 0;
+        return;
+    }
+    if ( ++statistics.failuresInRow < FALLBACK_FAILURES )
+        return;
+    statistics.failuresInRow = 0; // count the next series
+    if ( scope && scope->horizontal.samplerateFallback && sampleIndex > 0 )
+        statistics.unstable = true;
+    transferErrors = int( sampleIndex ); // handled by stateMachine()
+}
+
+
+void HantekDsoControl::reportTransferErrors( unsigned sampleIndex ) {
+    if ( sampleIndex >= controlsettings.samplerate.statistics.size() )
+        return;
+    const Dso::ControlSamplerateStatistics &statistics = controlsettings.samplerate.statistics[ sampleIndex ];
+    const double samplerate = specification->fixedSampleRates[ sampleIndex ].samplerate;
+    QString message = tr( "Repeated USB transfer errors at %1 (%2 overruns and %3 short transfers in %4 frames)" )
+                          .arg( valueToString( samplerate, UNIT_SAMPLES, -1 ) + tr( "/s" ) )
+                          .arg( statistics.overruns.load() )
+                          .arg( statistics.shortTransfers.load() )
+                          .arg( statistics.frames.load() );
+    if ( !isStable( sampleIndex ) ) {
+        updateSamplerateLimits(); // remove the unstable samplerates from the list
+        restoreTargets();         // and select the next stable samplerate
+        const QString current = valueToString( controlsettings.samplerate.current, UNIT_SAMPLES, -1 ) + tr( "/s" );
+        message += tr( ", switched to %1" ).arg( current );
+        if ( !isSingleChannel() )
+            message += tr( " (use only CH1 for higher samplerates)" );
+        retestTimer.start();
+    }
+    qWarning() << message;
+    emit statusMessage( message, 0 );
+}
+
+
+// the USB load may have changed (other devices on the hub), give the unstable samplerates another chance
+void HantekDsoControl::retestSamplerates() {
+    if ( !retestTimer.isValid() || !retestTimer.hasExpired( UNSTABLE_RETEST ) )
+        return;
+    retestTimer.invalidate();
+    for ( Dso::ControlSamplerateStatistics &statistics : controlsettings.samplerate.statistics )
+        statistics.unstable = false;
+    updateSamplerateLimits(); // offer all samplerates again
+    restoreTargets();         // and retry the target samplerate
 }
 
 
@@ -449,22 +688,57 @@ void HantekDsoControl::quitSampling() {
 void HantekDsoControl::convertRawDataToSamples() {
     QReadLocker rawLocker( &raw.lock );
     activeChannels = raw.channels;
-    const unsigned rawSampleCount = unsigned( raw.data.size() ) / activeChannels;
+    if ( raw.freeRun && !raw.rollMode ) // free run restarts rolling, raw.data holds no valid samples
+        return;
+    // (roll mode) take a consistent copy without blocking the writer, "old" samples left, "new" samples right
+    const bool rolling = raw.freeRun;
+    uint64_t rollEnd = 0; // total byte count at the end of rollData
+    if ( rolling && !raw.rollBuffer.read( rollData, rollEnd ) )
+        return; // the writer overtook all copy attempts, skip this frame
+    const std::vector< unsigned char > &rawData = rolling ? rollData : raw.data;
+    const unsigned rawSampleCount = unsigned( rawData.size() ) / activeChannels;
     if ( !rawSampleCount )
         return;
     const unsigned rawOversampling = raw.oversampling;
-    const bool freeRunning = rawSampleCount / rawOversampling < SAMPLESIZE; // amount needed for sw trigger
-    const unsigned sampleCount = freeRunning ? rawSampleCount : netSampleCount( rawSampleCount );
+    const bool spectrumOnly = raw.spectrum; // record for span and RBW, drop the settling samples, no trigger search
+    const bool freeRunning = !spectrumOnly && rawSampleCount / rawOversampling < SAMPLESIZE; // amount needed for sw trigger
+    const unsigned sampleCount = freeRunning  ? rawSampleCount
+                                 : raw.settled ? rawSampleCount - rawSampleCount % 1000 // drop the USB packet rounding
+                                               : netSampleCount( rawSampleCount );
     const unsigned resultSamples = freeRunning ? sampleCount / rawOversampling - 1 : sampleCount / rawOversampling;
-    const unsigned skipSamples = rawSampleCount - sampleCount;
+    unsigned skipSamples = rawSampleCount - sampleCount;
+    const DecimationKernel decimate = decimationKernel( activeChannels, rawOversampling ); // unrolled for this setting
     QWriteLocker resultLocker( &result.lock );
-    result.freeRunning = freeRunning;
+    result.rollTotal = -1;
+    if ( rolling ) {
+        // align the oversampling blocks to the continuous sample stream, i.e. each displayed sample
+        // keeps its value while rolling and only the new samples must be appended to the graph
+        const int64_t blockSize = rawOversampling * activeChannels;
+        const int64_t rollStart = int64_t( rollEnd ) - int64_t( rawData.size() ); // stream position of rawData[ 0 ]
+        const int64_t alignment = ( ( -rollStart ) % blockSize + blockSize ) % blockSize;
+        skipSamples = unsigned( alignment ) / activeChannels; // < rawOversampling, resultSamples has one sample spare
+        result.rollTotal = ( rollStart + alignment ) / blockSize + resultSamples;
+    }
+    // continuous stream: the raw positions tell if this frame directly continues the previous one
+    result.streamStart = raw.streamStart < 0 || rolling ? -1 : raw.streamStart + skipSamples;
+    result.streamEnd = result.streamStart < 0 ? -1 : result.streamStart + int64_t( resultSamples ) * rawOversampling;
+    result.freeRunning = freeRunning || spectrumOnly;
+    result.spectrumOnly = spectrumOnly;
     result.tag = raw.tag;
+    result.requestTime = raw.requestTime;
+    result.completionTime = raw.completionTime;
+    result.deadTime = raw.deadTime;
+    result.dutyCycle = raw.dutyCycle;
+    result.detail = raw.detail;
+    result.hasDetail = detailSampleIndex && !raw.detail;
     result.samplerate = raw.samplerate / raw.oversampling;
     // Prepare result buffers
     result.data.resize( specification->channels );
-    for ( ChannelID channelCounter = 0; channelCounter < specification->channels; ++channelCounter )
+    for ( ChannelID channelCounter = 0; channelCounter < specification->channels; ++channelCounter ) {
         result.data[ channelCounter ].clear();
+        if ( channelCounter < 2 )
+            result.inputPeak[ channelCounter ] = -1;
+    }
 
     // Convert channel data
     // Channels are using their separate buffers
@@ -499,26 +773,55 @@ void HantekDsoControl::convertRawDataToSamples() {
             }
         }
         // Convert data from the oscilloscope and write it into the channel sample buffer
-        unsigned rawBufPos = 0;
-        if ( raw.freeRun && raw.rollMode ) // show the "new" samples on the right screen side
-            rawBufPos = raw.received;      // start with remaining "old" samples in buffer
+        const unsigned rawBufPos = skipSamples * activeChannels; // skip first unstable samples
+        const double factor = sign / voltageScale * gainCalibration * probeAttn;
         result.data[ channel ].resize( resultSamples );
-        rawBufPos += skipSamples * activeChannels; // skip first unstable samples
-        result.clipped &= ~( 0x01 << channel );    // clear clipping flag
-        for ( unsigned index = 0; index < resultSamples;
-              ++index, rawBufPos += activeChannels * rawOversampling ) { // advance either by one or two blocks
-            if ( rawBufPos + rawOversampling * activeChannels > rawSampleCount * activeChannels )
-                rawBufPos = 0; // (roll mode) show "new" samples after the "old" samples
-            double sample = 0.0;
-            for ( unsigned iii = 0; iii < rawOversampling * activeChannels; iii += activeChannels ) {
-                int rawSample = raw.data[ rawBufPos + channel + iii ]; // CH1/CH2/CH1/CH2 ...
-                if ( rawSample == 0x00 || rawSample == 0xFF )          // min or max -> clipped
-                    result.clipped |= 0x01 << channel;
-                sample += double( rawSample ) - voltageOffset;
+        result.clipped &= ~( 0x01 << channel ); // clear clipping flag
+        bool clipped;
+        const TransferFunction &sensor = controlsettings.voltage[ channel ].sensor;
+        if ( sensor.isIdentity() ) {
+            clipped = decimate( rawData.data() + rawBufPos + channel, result.data[ channel ].data(), resultSamples, voltageOffset,
+                                factor, activeChannels, rawOversampling ); // CH1/CH2/CH1/CH2 ...
+        } else {
+            // there are only 256 ADC codes -> apply the (nonlinear) sensor function once per code and gain setting
+            SensorTable &table = sensorTables[ channel ];
+            if ( !table.valid || table.offset != voltageOffset || table.factor != factor ) {
+                // the sign is applied to the sensor value, i.e. an inverted channel shows the negative value
+                for ( unsigned code = 0; code < 256; ++code )
+                    table.value[ code ] = sign * sensor( ( code - voltageOffset ) * factor * sign );
+                table.offset = voltageOffset;
+                table.factor = factor;
+                table.valid = true;
+            }
+            clipped = decimateTable( rawData.data() + rawBufPos + channel, result.data[ channel ].data(), resultSamples,
+                                     table.value, activeChannels, rawOversampling );
+        }
+        if ( clipped )
+            result.clipped |= 0x01 << channel;
+        // autorange: the input level from the ADC codes, independent of offset and curve of a sensor function
+        if ( channel < 2 && scope && scope->voltage[ channel ].autoRange ) {
+            const unsigned char *code = rawData.data() + rawBufPos + channel;
+            const unsigned char *end = code + size_t( resultSamples ) * rawOversampling * activeChannels;
+            unsigned char low = 0xFF;
+            unsigned char high = 0x00;
+            for ( ; code < end; code += activeChannels ) {
+                low = qMin( low, *code );
+                high = qMax( high, *code );
             }
-            sample /= rawOversampling;
-            result.data[ channel ][ index ] = sign * sample / voltageScale * gainCalibration * probeAttn;
+            if ( low <= high )
+                result.inputPeak[ channel ] = qMax( fabs( high - voltageOffset ), fabs( low - voltageOffset ) ) * fabs( factor );
         }
+        result.rawFrame.offset[ channel ] = voltageOffset;
+        result.rawFrame.factor[ channel ] = factor;
+    }
+    // raw recording: compress the converted part, SD cards and USB sticks cannot keep up with the ADC stream
+    if ( rawRecording ) {
+        result.rawFrame.samplerate = raw.samplerate;
+        result.rawFrame.oversampling = rawOversampling;
+        adcEncode( rawData.data() + skipSamples * activeChannels, size_t( resultSamples ) * rawOversampling * activeChannels,
+                   activeChannels, result.rawFrame.encoded );
+    } else {
+        result.rawFrame.encoded.clear();
     }
 }
 
@@ -540,12 +843,11 @@ unsigned HantekDsoControl::searchTriggerPoint( Dso::Slope dsoSlope, unsigned int
     if ( startPos >= sampleCount )
         return 0;
     double level = controlsettings.trigger.level[ channel ];
-    double timeDisplay = controlsettings.samplerate.target.duration; // time for full screen width
-    double sampleRate = controlsettings.samplerate.current;
+    double timeDisplay = displayDuration(); // time for full screen width (or zoomed window)
+    double sampleRate = displaySamplerate();
     double samplesDisplay = timeDisplay * sampleRate;
 
-    unsigned preTrigSamples =
-        startPos ? startPos : unsigned( controlsettings.trigger.position * samplesDisplay ); // samples left of trigger
+    unsigned preTrigSamples = startPos ? startPos : unsigned( displayPosition() * samplesDisplay ); // samples left of trigger
     unsigned postTrigSamples =
         unsigned( sampleCount ) - ( unsigned( samplesDisplay ) - preTrigSamples ); // samples right of trigger
     // |-----------samples-----------| // available sample
@@ -612,15 +914,31 @@ unsigned HantekDsoControl::searchTriggeredPosition() {
     double pulseWidth1 = 0.0;
     double pulseWidth2 = 0.0;
 
-    size_t sampleCount = result.data[ channel ].size();              // number of available samples
-    double timeDisplay = controlsettings.samplerate.target.duration; // time for full screen width
-    double sampleRate = result.samplerate;                           //
-    double samplesDisplay = timeDisplay * controlsettings.samplerate.current;
+    size_t sampleCount = result.data[ channel ].size(); // number of available samples
+    double timeDisplay = displayDuration();             // time for full screen width (or zoomed window)
+    double sampleRate = result.samplerate;              //
+    double samplesDisplay = timeDisplay * displaySamplerate();
     if ( sampleCount < samplesDisplay ) // not enough samples to adjust for jitter.
         return result.triggeredPosition = 0;
     // search for trigger point in a range that leaves enough samples left and right of trigger for display
     // find also the alternate slope after trigger point -> calculate pulse width.
-    if ( controlsettings.trigger.slope != Dso::Slope::Both ) {
+    if ( serialTrigger.isActive() ) { // decoded bus content, no pulse width
+        // UART decodes the trigger source, SPI and I2C use CH1 as clock and CH2 as data
+        const bool uart = serialTrigger.getProtocol() == Dso::SerialProtocol::UART;
+        const ChannelID line1 = uart ? channel : 0;
+        const std::vector< double > *line2 = !uart && result.data.size() > 1 ? &result.data[ 1 ] : nullptr;
+        const unsigned preTrigSamples = unsigned( displayPosition() * samplesDisplay );
+        const unsigned postTrigSamples = unsigned( sampleCount ) - ( unsigned( samplesDisplay ) - preTrigSamples );
+        // keep the decoder state only if no sample is missing between the last and this frame
+        const bool continues = result.streamStart >= 0 && result.streamStart == serialStreamEnd;
+        serialStreamEnd = result.streamEnd;
+        const unsigned found =
+            serialTrigger.search( result.data[ line1 ], line2, controlsettings.trigger.level[ line1 ],
+                                  controlsettings.trigger.level.size() > 1 ? controlsettings.trigger.level[ 1 ] : 0,
+                                  sampleRate, qMax( preTrigSamples, 1u ), postTrigSamples, result.tag, continues );
+        if ( found != SerialTrigger::NOT_FOUND ) // the window starts at 1, position 0 means "not triggered"
+            triggeredPositionRaw = found;
+    } else if ( controlsettings.trigger.slope != Dso::Slope::Both ) {
         triggeredPositionRaw = searchTriggerPoint( nextSlope = controlsettings.trigger.slope );
         if ( triggeredPositionRaw ) { // triggered -> search also following other slope (calculate pulse width)
             if ( unsigned int slopePos2 = searchTriggerPoint( mirrorSlope( nextSlope ), triggeredPositionRaw ) ) {
@@ -654,21 +972,31 @@ unsigned HantekDsoControl::searchTriggeredPosition() {
 
 bool HantekDsoControl::provideTriggeredData() {
     // printf( "HDC::provideTriggeredData()\n" );
-    static DSOsamples triggeredResult; // storage for last triggered trace samples
+    static DSOsamples triggeredResults[ 2 ]; // storage for last triggered trace samples (overview and detail)
+    DSOsamples &triggeredResult = triggeredResults[ result.detail ? 1 : 0 ];
     if ( result.triggeredPosition ) {  // live trace has triggered
         // Use this trace and save it also
         triggeredResult.data = result.data;
         triggeredResult.samplerate = result.samplerate;
         triggeredResult.clipped = result.clipped;
+        triggeredResult.inputPeak[ 0 ] = result.inputPeak[ 0 ];
+        triggeredResult.inputPeak[ 1 ] = result.inputPeak[ 1 ];
         triggeredResult.triggeredPosition = result.triggeredPosition;
+        triggeredResult.requestTime = result.requestTime;
+        triggeredResult.completionTime = result.completionTime;
         result.liveTrigger = true;
     } else if ( controlsettings.trigger.mode == Dso::TriggerMode::NORMAL ) { // Not triggered in NORMAL mode
         // Use saved trace (even if it is empty)
         result.data = triggeredResult.data;
         result.samplerate = triggeredResult.samplerate;
         result.clipped = triggeredResult.clipped;
+        result.inputPeak[ 0 ] = triggeredResult.inputPeak[ 0 ];
+        result.inputPeak[ 1 ] = triggeredResult.inputPeak[ 1 ];
         result.triggeredPosition = triggeredResult.triggeredPosition;
-        result.liveTrigger = false; // show red "TR" top left
+        result.requestTime = triggeredResult.requestTime; // time stamps of the saved trace, dead time of the live frame
+        result.completionTime = triggeredResult.completionTime;
+        result.rawFrame.encoded.clear(); // no new raw data for the saved trace
+        result.liveTrigger = false;      // show red "TR" top left
     } else {                        // Not triggered and not NORMAL mode
         // Use the free running trace, discard history
         triggeredResult.data.clear();          // discard trace
@@ -706,10 +1034,17 @@ void HantekDsoControl::stateMachine() {
     static bool lastTriggered = false; // state of last frame
     static bool skipEven = true;       // even or odd frames were skipped
     static unsigned lastTag = 0;
+    static bool lastDetail = true; // dual timebase: kind of the last displayed frame
 
     bool triggered = false;
+    const int failedIndex = transferErrors.exchange( -1 );
+    if ( failedIndex >= 0 ) // too many USB transfer errors
+        reportTransferErrors( unsigned( failedIndex ) );
+    else
+        retestSamplerates();
     // we have a sample available ...
     // ... that is either a new sample or we are in free run mode or a new trigger search is needed
+    updateDetailTimebase();
     if ( samplingStarted && raw.valid && ( raw.tag != lastTag || raw.freeRun || triggerChanged() ) ) {
         lastTag = raw.tag;
         convertRawDataToSamples(); // process samples, apply gain settings etc.
@@ -732,12 +1067,19 @@ void HantekDsoControl::stateMachine() {
     // always run the display (slowly at t=displayInterval) to allow user interaction
     // ... but update immediately if new triggered data is available after untriggered
     // skip an even number of frames when slope == Dso::Slope::Both
-    if ( ( triggered && !lastTriggered )                                 // show new data immediately
-         || ( ( delayDisplay >= displayInterval )                        // or wait some time ...
-              && ( ( controlsettings.trigger.slope != Dso::Slope::Both ) // ... for ↗ or ↘ slope
-                   || skipEven ) ) ) {                                   // and drop even no. of frames
-        skipEven = true;                                                 // zero frames -> even
+    // dual timebase: show overview and detail frames alternately (but don't wait forever for the other kind)
+    const bool sameKind = detailSampleIndex && result.detail == lastDetail && delayDisplay < 2 * displayInterval;
+    if ( !sameKind && ( ( triggered && !lastTriggered )                                 // show new data immediately
+                        || ( ( delayDisplay >= displayInterval )                        // or wait some time ...
+                             && ( ( controlsettings.trigger.slope != Dso::Slope::Both ) // ... for ↗ or ↘ slope
+                                  || skipEven ) ) ) ) {                                 // and drop even no. of frames
+        skipEven = true;                                                                // zero frames -> even
         delayDisplay = 0;
+        lastDetail = result.detail;
+        {
+            QWriteLocker resultLocker( &result.lock );
+            updateRegionOfInterest(); // once per displayed frame with the current timebase and trigger position
+        }
         timestampDebug( QString( "samplesAvailable %1" ).arg( result.tag ) );
         emit samplesAvailable( &result ); // via signal/slot -> PostProcessing::input()
     } else {
@@ -9,7 +9,9 @@
 #include "controlspecification.h"
 #include "dsosamples.h"
 #include "errorcodes.h"
+#include "rollbuffer.h"
 #include "scopesettings.h"
+#include "serialtrigger.h"
 #include "utils/printutils.h"
 #include "viewconstants.h"
 
@@ -18,8 +20,10 @@
 
 #include "dsomodel.h"
 
+#include <atomic>
 #include <vector>
 
+#include <QElapsedTimer>
 #include <QMutex>
 #include <QReadLocker>
 #include <QReadWriteLock>
@@ -38,12 +42,21 @@ struct Raw {
     unsigned gainValue[ 2 ] = {1, 1}; // 1,2,5,10,..
     unsigned gainIndex[ 2 ] = {7, 7}; // index 0..7
     unsigned tag = 0;
-    bool freeRun = false;  // small buffer, no trigger
-    bool valid = false;    // samples can be processed
-    bool rollMode = false; // one complete buffer received, start to roll
+    bool freeRun = false;       // small buffer, no trigger
+    bool valid = false;         // samples can be processed
+    bool rollMode = false;      // roll buffer is valid, keep on rolling
+    bool settled = false;       // cut from the continuous stream, no unstable leading samples
+    int64_t streamStart = -1;   // continuous stream: position of data[ 0 ] in samples per channel, -1 = no stream
+    bool detail = false;        // dual timebase: captured with the detail samplerate
+    bool spectrum = false;      // spectrum acquisition: record length for span and RBW, no trigger
+    int64_t requestTime = 0;    // ns, monotonic, the USB transfer of this frame was requested
+    int64_t completionTime = 0; // ns, monotonic, the USB transfer of this frame was completed
+    double deadTime = 0;        // s, time between the previous and this frame without samples
+    double dutyCycle = 1;       // smoothed ratio of observed time to total time
     unsigned size = 0;
     unsigned received = 0;
     std::vector< unsigned char > data;
+    RollBuffer rollBuffer; // free run samples, written without lock by the capturing thread
     mutable QReadWriteLock lock;
 };
 
@@ -80,7 +93,9 @@ class HantekDsoControl : public QObject {
     static const unsigned SAMPLESIZE = 20000;
     static const unsigned SAMPLESIZE_ROLL = 39 * 256;
     unsigned getSamplesize() const {
-        if ( controlsettings.trigger.mode == Dso::TriggerMode::ROLL )
+        if ( spectrumSamplesize )
+            return spectrumSamplesize;
+        else if ( controlsettings.trigger.mode == Dso::TriggerMode::ROLL )
             return SAMPLESIZE_ROLL;
         else
             return SAMPLESIZE;
@@ -140,6 +155,9 @@ class HantekDsoControl : public QObject {
     /// calculate backwards to get multiples of 1000 (typical 20000 or 10000)
     unsigned netSampleCount( unsigned gross ) const { return ( ( gross - 1024 ) / 1000 - 1 ) * 1000; }
 
+    /// continuous stream: the samples are already settled, just round up to full USB packets
+    unsigned streamSampleCount( unsigned net ) const { return ( net + 1023 ) / 1024 * 1024; }
+
     void updateInterval();
 
     /// \brief Calculates the trigger point from the CommandGetCaptureState data.
@@ -167,10 +185,40 @@ class HantekDsoControl : public QObject {
 
     unsigned searchTriggeredPosition();
 
+    /// \brief Select the samplerate and trigger window of the dual timebase detail frames.
+    void updateDetailTimebase();
+
+    /// \brief Select samplerate and record length for the spectrum span and RBW, restore the targets if inactive.
+    void updateSpectrumAcquisition();
+
+    /// \brief ROI mode: select the displayed window plus margins for the post processing.
+    void updateRegionOfInterest();
+
+    /// time around the trigger point that is shown, the zoomed window for detail frames
+    double displayDuration() const { return result.detail ? detailDuration : controlsettings.samplerate.target.duration; }
+    double displayPosition() const { return result.detail ? detailPosition : controlsettings.trigger.position; }
+    double displaySamplerate() const { return result.detail ? result.samplerate : controlsettings.samplerate.current; }
+
     bool provideTriggeredData();
 
     void controlSetSamplerate( uint8_t sampleIndex );
 
+    /// \brief Update the USB transfer statistics, called by the capturing thread after each frame.
+    /// \param sampleIndex The index of the used fixed samplerate.
+    /// \param overrun The USB transfer failed (FIFO overrun, timeout).
+    /// \param shortTransfer Less samples than requested were received.
+    void countTransfer( unsigned sampleIndex, bool overrun, bool shortTransfer );
+    /// \brief Show the statistics after repeated transfer errors, switch to the next stable samplerate
+    /// if the fallback policy has marked the samplerate as unstable.
+    /// \param sampleIndex The index of the fixed samplerate with the errors.
+    void reportTransferErrors( unsigned sampleIndex );
+    /// \brief Offer the unstable samplerates again and retry the target samplerate after UNSTABLE_RETEST ms.
+    void retestSamplerates();
+    /// \brief The fixed samplerate is not marked as unstable by the fallback policy.
+    bool isStable( unsigned sampleIndex ) const;
+    static const unsigned FALLBACK_FAILURES = 3; ///< consecutive failures before a samplerate is unstable
+    static const int UNSTABLE_RETEST = 60000;    ///< ms until the unstable samplerates are tested again
+
     /// Pointers to control commands
     ControlCommand *control[ 255 ] = {nullptr};
     ControlCommand *firstControlCommand = nullptr;
@@ -198,14 +246,40 @@ class HantekDsoControl : public QObject {
     int displayInterval = 0;
     unsigned triggeredPositionRaw = 0; // not triggered
     unsigned activeChannels = 2;
-    bool newTriggerParam = false; // parameter changed -> new trigger search needed
+    bool newTriggerParam = false;     // parameter changed -> new trigger search needed
+    std::atomic< int > transferErrors{-1};   // capturing reports repeated errors at this samplerate index, -1 = none
+    std::atomic< unsigned > restartCount{0}; // incremented with each restartSampling(), a stopped transfer is no failure
+    QElapsedTimer retestTimer;               // started when a samplerate was marked as unstable
+    bool dualTimebase = false;        // the zoomed scope is shown and shall get detail frames
+    std::atomic< unsigned > detailSampleIndex{0}; // dual timebase: samplerate index of the detail frames, 0 = off
+    double detailDuration = 0;        // dual timebase: time span of the zoomed window incl. trigger point
+    double detailPosition = 0;        // dual timebase: trigger position in this span (0.0 .. 1.0)
+    bool spectrumAcquisition = false; // spectrum acquisition is selected
+    double spectrumSpan = 20e3;       // spectrum acquisition: highest frequency of interest
+    double spectrumRbw = 10;          // spectrum acquisition: resolution bandwidth = frequency bin width
+    unsigned spectrumSamplesize = 0;  // spectrum acquisition: record length of the active mode, 0 = inactive
+    unsigned spectrumSampleIndex = 0; // spectrum acquisition: fixed samplerate index of the active mode
+    bool rawRecording = false;        // an exporter records the compressed ADC samples of each frame
     bool triggerChanged() {
         bool changed = newTriggerParam;
         newTriggerParam = false;
         return changed;
     }
 
+    SerialTrigger serialTrigger; ///< trigger on decoded serial bus content, used under result.lock
+    int64_t serialStreamEnd = -1; ///< raw stream position after the last frame fed into the serial trigger
+
     Raw raw;
+    std::vector< unsigned char > rollData; ///< consistent copy of raw.rollBuffer
+
+    /// \brief ADC code -> sensor value for a channel with transfer function, rebuilt if the conversion parameters change
+    struct SensorTable {
+        bool valid = false; ///< false: (re)build before use
+        double offset = 0;  ///< ADC code for 0V used for this table
+        double factor = 0;  ///< V per ADC step (incl. sign, calibration and probe) used for this table
+        double value[ 256 ];
+    };
+    std::vector< SensorTable > sensorTables; ///< one table per channel
 
     std::vector< QString > controlNames = {"SETGAIN_CH1",    "SETGAIN_CH2", "SETSAMPLERATE", "STARTSAMPLING",
                                            "SETNUMCHANNELS", "SETCOUPLING", "SETCALFREQ"};
@@ -261,6 +335,12 @@ class HantekDsoControl : public QObject {
     /// \return error code.
     Dso::ErrorCode setGain( ChannelID channel, double gain );
 
+    /// \brief Sets the sensor transfer function for the given channel.
+    /// \param channel The channel that should be set.
+    /// \param sensor Maps the input voltage to the sensor unit, identity = no sensor.
+    /// \return error code.
+    Dso::ErrorCode setSensor( ChannelID channel, const TransferFunction &sensor );
+
     /// \brief Sets the coupling for the given channel.
     /// \param channel The channel that should be set.
     /// \param coupling The coupling that should be set.
@@ -297,6 +377,30 @@ class HantekDsoControl : public QObject {
     /// \return The trigger position that has been set.
     Dso::ErrorCode setTriggerOffset( double position );
 
+    /// \brief Set the serial trigger, replaces the slope trigger if a protocol is selected.
+    /// \param protocol The serial protocol, OFF = slope trigger.
+    /// \param pattern The byte pattern, see SerialTrigger.
+    /// \param baudrate The UART bit rate.
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setSerialTrigger( Dso::SerialProtocol protocol, const QString &pattern, unsigned baudrate );
+
+    /// \brief Enable the alternating detail captures for the zoomed scope.
+    /// \param enabled Dual timebase is selected and the zoomed scope is shown.
+    void setDualTimebase( bool enabled ) { dualTimebase = enabled; }
+
+    /// \brief Keep a compressed copy of the converted ADC samples in each frame, see RawFrame.
+    /// \param enabled An exporter records raw data.
+    void setRawRecording( bool enabled ) { rawRecording = enabled; }
+
+    /// \brief Select samplerate and record length from the frequency span and the resolution bandwidth.
+    /// The mode is active only if spectrum channels but no voltage channels are shown (trigger mode != ROLL),
+    /// the trigger search is skipped and the samplerate or record time of the horizontal dock are kept as target.
+    /// \param enabled Spectrum acquisition is selected.
+    /// \param span The highest frequency of interest in Hz.
+    /// \param rbw The resolution bandwidth (frequency bin width) in Hz.
+    /// \return See ::Dso::ErrorCode.
+    Dso::ErrorCode setSpectrumAcquisition( bool enabled, double span, double rbw );
+
     /// \brief Sets the calibration frequency of the oscilloscope.
     /// \param calfreq The calibration frequency.
     /// \return The tfrequency that has been set, ::Dso::ErrorCode on error.
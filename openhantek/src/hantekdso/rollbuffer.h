@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+/// \brief Single writer ring buffer for the raw samples in roll mode.
+///
+/// The capturing thread copies the USB packets into the buffer and publishes them
+/// by advancing the atomic write cursor, it never waits for a reader.
+/// A reader copies the latest `size()` bytes (oldest first) and checks with the total byte counter
+/// if the writer has overwritten a part of this range during the copy (seqlock pattern).
+/// The buffer is `slack` bytes larger than the visible range and the writer stores at most `slack / 2`
+/// bytes ahead of the cursor, i.e. a copy is only torn if more than `slack / 2` bytes were published meanwhile.
+/// The bytes are accessed atomically (relaxed, plain loads and stores on all common CPUs), so concurrent
+/// access is well defined and the fences make a torn copy detectable also on weakly ordered CPUs.
+/// `resize()` is not thread safe, the caller must lock out the readers, e.g. with `Raw::lock`.
+class RollBuffer {
+  public:
+    /// \brief Allocate the buffer, fill it with "zeros" and reset the cursor.
+    /// \param size The number of bytes that are visible for the reader.
+    /// \param slack Additional bytes that can be written without disturbing the reader.
+    /// \param fill The initial value of all bytes, ADC format: binary offset 0x80 = 0V.
+    void resize( unsigned size, unsigned slack, uint8_t fill = 0x80 ) {
+        visible = size;
+        maxChunk = slack / 2;
+        capacity = size + slack;
+        buffer.reset( new std::atomic< uint8_t >[ capacity ] );
+        for ( unsigned index = 0; index < capacity; ++index )
+            buffer[ index ].store( fill, std::memory_order_relaxed );
+        written.store( 0, std::memory_order_release );
+    }
+
+    /// \brief The number of bytes that are visible for the reader.
+    unsigned size() const { return visible; }
+
+    /// \brief The total number of bytes written since the last `resize()`.
+    uint64_t total() const { return written.load( std::memory_order_acquire ); }
+
+    /// \brief Writer: append `length` bytes and publish them in steps of at most `slack / 2` bytes.
+    /// \param data The new bytes.
+    /// \param length Number of bytes.
+    void write( const unsigned char *data, unsigned length ) {
+        if ( !capacity || !maxChunk )
+            return;
+        while ( length ) {
+            const unsigned chunk = std::min( length, maxChunk );
+            const uint64_t end = written.load( std::memory_order_relaxed );
+            // a reader that sees one of the following stores sees also the cursor `end` (or later)
+            std::atomic_thread_fence( std::memory_order_release );
+            unsigned pos = unsigned( end % capacity );
+            for ( unsigned index = 0; index < chunk; ++index ) {
+                buffer[ pos ].store( data[ index ], std::memory_order_relaxed );
+                if ( ++pos == capacity )
+                    pos = 0;
+            }
+            written.store( end + chunk, std::memory_order_release );
+            data += chunk;
+            length -= chunk;
+        }
+    }
+
+    /// \brief Reader: copy the latest `size()` bytes into `target`, oldest bytes first.
+    /// \param target The destination, is resized to `size()`.
+    /// \param end Returns the total byte count at the end of the copied range.
+    /// \param attempts Number of copies before giving up.
+    /// \return true if the copy is consistent, false if the writer was faster during all attempts.
+    bool read( std::vector< unsigned char > &target, uint64_t &end, int attempts = 3 ) const {
+        target.resize( visible );
+        end = 0;
+        if ( !visible )
+            return true;
+        const uint64_t safeDistance = capacity - visible - maxChunk; // writer may advance this far
+        for ( int attempt = 0; attempt < attempts; ++attempt ) {
+            end = written.load( std::memory_order_acquire );
+            // bytes "before" the first write still hold the fill value
+            unsigned pos = unsigned( ( end + capacity - visible ) % capacity );
+            for ( unsigned index = 0; index < visible; ++index ) {
+                target[ index ] = buffer[ pos ].load( std::memory_order_relaxed );
+                if ( ++pos == capacity )
+                    pos = 0;
+            }
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if ( written.load( std::memory_order_relaxed ) - end <= safeDistance )
+                return true;
+        }
+        return false;
+    }
+
+  private:
+    std::unique_ptr< std::atomic< uint8_t >[] > buffer;
+    unsigned capacity = 0;
+    unsigned visible = 0;
+    unsigned maxChunk = 0;
+    std::atomic< uint64_t > written{0}; ///< total number of published bytes = write cursor
+};
@@ -0,0 +1,198 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <QRegularExpression>
+#include <QStringList>
+#include <algorithm>
+#include <climits>
+
+#include "serialtrigger.h"
+
+
+// Parse one pattern token into value and care mask (bits that must match), START is returned as value 256
+static bool parseToken( const QString &token, unsigned &value, unsigned &care ) {
+    bool ok = true;
+    if ( token.compare( "S", Qt::CaseInsensitive ) == 0 ) { // start condition
+        value = 256;
+        care = 0x1FF;
+    } else if ( token.size() == 3 && token.startsWith( '\'' ) && token.endsWith( '\'' ) ) { // 'A'
+        value = unsigned( token.at( 1 ).toLatin1() ) & 0xFF;
+        care = 0xFF;
+    } else if ( token.startsWith( '@' ) ) { // I2C 7 bit address, R/W don't care
+        const unsigned address = token.mid( 1 ).toUInt( &ok, 16 );
+        ok = ok && address < 0x80;
+        value = address << 1;
+        care = 0xFE;
+    } else if ( token.startsWith( "0b", Qt::CaseInsensitive ) ) { // binary with don't care bits
+        const QString bits = token.mid( 2 );
+        ok = bits.size() == 8;
+        value = care = 0;
+        for ( const QChar bit : bits ) {
+            value <<= 1;
+            care <<= 1;
+            if ( bit == '1' ) {
+                value |= 1;
+                care |= 1;
+            } else if ( bit == '0' ) {
+                care |= 1;
+            } else if ( bit.toLower() != 'x' && bit != '?' ) {
+                ok = false;
+            }
+        }
+    } else { // hex with don't care nibbles
+        QString nibbles = token.startsWith( "0x", Qt::CaseInsensitive ) ? token.mid( 2 ) : token;
+        if ( nibbles.size() == 1 )
+            nibbles.prepend( '0' );
+        ok = nibbles.size() == 2;
+        value = care = 0;
+        for ( const QChar nibble : nibbles ) {
+            value <<= 4;
+            care <<= 4;
+            if ( nibble != '?' && nibble.toLower() != 'x' ) {
+                const int digit = QString( nibble ).toInt( &ok, 16 );
+                value |= unsigned( digit );
+                care |= 0xF;
+            }
+            if ( !ok )
+                break;
+        }
+    }
+    return ok;
+}
+
+
+bool SerialTrigger::setup( Dso::SerialProtocol newProtocol, const QString &pattern, unsigned newBaudrate ) {
+    protocol = Dso::SerialProtocol::OFF;
+    patternLength = 0;
+    std::fill( symbolMask, symbolMask + START + 1, 0 );
+    state = State();
+    frameValid = false;
+    baudrate = newBaudrate ? newBaudrate : 9600;
+    const QStringList tokens = pattern.split( QRegularExpression( "\\s+" ), QString::SkipEmptyParts );
+    if ( newProtocol == Dso::SerialProtocol::OFF || tokens.isEmpty() )
+        return newProtocol == Dso::SerialProtocol::OFF;
+    if ( unsigned( tokens.size() ) > MAX_PATTERN )
+        return false;
+    // build the shift-and automaton: bit i of symbolMask[ s ] is set if symbol s matches token i
+    unsigned index = 0;
+    for ( const QString &token : tokens ) {
+        unsigned value;
+        unsigned care;
+        if ( !parseToken( token, value, care ) ) {
+            std::fill( symbolMask, symbolMask + START + 1, 0 );
+            return false;
+        }
+        const uint64_t bit = uint64_t( 1 ) << index++;
+        if ( value == START )
+            symbolMask[ START ] |= bit;
+        else
+            for ( unsigned symbol = 0; symbol < START; ++symbol )
+                if ( ( ( symbol ^ value ) & care ) == 0 )
+                    symbolMask[ symbol ] |= bit;
+    }
+    patternLength = index;
+    finalMask = uint64_t( 1 ) << ( patternLength - 1 );
+    protocol = newProtocol;
+    return true;
+}
+
+
+unsigned SerialTrigger::search( const std::vector< double > &line1, const std::vector< double > *line2, double level1,
+                                double level2, double samplerate, unsigned first, unsigned last, unsigned tag,
+                                bool continues ) {
+    if ( !isActive() )
+        return NOT_FOUND;
+    if ( frameValid && tag == frameTag ) // same frame again, e.g. new trigger level -> repeat with the same start state
+        state = frameState;
+    else if ( !continues ) // gap or new stream -> a character or frame in progress is lost
+        state = State();
+    frameState = state;
+    frameTag = tag;
+    frameValid = true;
+
+    unsigned found = NOT_FOUND;
+    unsigned sampleCount = unsigned( line1.size() );
+    if ( protocol == Dso::SerialProtocol::UART ) {
+        const double samplesPerBit = samplerate / baudrate;
+        if ( samplesPerBit < 3 ) // cannot sample the bits reliably
+            return NOT_FOUND;
+        for ( unsigned pos = 0; pos < sampleCount; ++pos ) {
+            const bool level = line1[ pos ] >= level1;
+            if ( !state.busy ) {
+                if ( state.line[ 0 ] && !level ) { // falling edge = start bit, sample in the middle of the bits
+                    state.busy = true;
+                    state.countdown = 1.5 * samplesPerBit;
+                    state.bits = 0;
+                    state.shift = 0;
+                }
+            } else if ( --state.countdown <= 0 ) {
+                state.countdown += samplesPerBit;
+                if ( state.bits < 8 ) { // data bits, LSB first
+                    state.shift |= unsigned( level ) << state.bits++;
+                } else { // stop bit, ignore the character if the stop bit is missing (framing error)
+                    state.busy = false;
+                    if ( level && feed( state.shift ) && found == NOT_FOUND && pos >= first && pos < last )
+                        found = pos;
+                }
+            }
+            state.line[ 0 ] = level;
+        }
+        return found;
+    }
+
+    if ( !line2 ) // SPI and I2C need the second channel
+        return NOT_FOUND;
+    sampleCount = std::min( sampleCount, unsigned( line2->size() ) );
+    for ( unsigned pos = 0; pos < sampleCount; ++pos ) {
+        const bool clock = line1[ pos ] >= level1;
+        const bool data = ( *line2 )[ pos ] >= level2;
+        bool match = false;
+        if ( protocol == Dso::SerialProtocol::SPI ) {
+            if ( state.sinceEdge < UINT_MAX )
+                ++state.sinceEdge;
+            if ( clock && !state.line[ 0 ] ) { // rising clock edge
+                // no frame yet or clock idle for more than 4 clock periods -> start of a new frame
+                if ( !state.busy || ( state.period && state.sinceEdge > 4 * state.period ) ) {
+                    state.busy = true;
+                    state.period = 0;
+                    state.bits = 0;
+                    state.shift = 0;
+                    match = feed( START );
+                } else {
+                    state.period = state.sinceEdge;
+                }
+                state.sinceEdge = 0;
+                state.shift = ( state.shift << 1 ) | unsigned( data ); // MSB first
+                if ( ++state.bits == 8 ) {
+                    match = feed( state.shift & 0xFF ) || match;
+                    state.bits = 0;
+                    state.shift = 0;
+                }
+            }
+        } else { // I2C
+            if ( clock && state.line[ 0 ] && data != state.line[ 1 ] ) { // SDA changes while SCL is high
+                if ( !data ) {                                         // (repeated) START
+                    state.busy = true;
+                    state.bits = 0;
+                    state.shift = 0;
+                    match = feed( START );
+                } else { // STOP
+                    state.busy = false;
+                }
+            } else if ( clock && !state.line[ 0 ] && state.busy ) { // rising SCL: 8 data bits (MSB first) + ACK
+                if ( ++state.bits <= 8 ) {
+                    state.shift = ( state.shift << 1 ) | unsigned( data );
+                    if ( state.bits == 8 )
+                        match = feed( state.shift & 0xFF );
+                } else {
+                    state.bits = 0;
+                    state.shift = 0;
+                }
+            }
+        }
+        if ( match && found == NOT_FOUND && pos >= first && pos < last )
+            found = pos;
+        state.line[ 0 ] = clock;
+        state.line[ 1 ] = data;
+    }
+    return found;
+}
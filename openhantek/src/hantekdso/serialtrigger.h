@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <QString>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+#include "enums.h"
+
+
+/// \brief Software trigger on decoded UART, SPI or I2C content.
+///
+/// The samples are converted to logic levels with the trigger level of each channel and fed into an incremental
+/// bus decoder, the decoded symbols (bytes and the start condition) are matched against the pattern
+/// with a precompiled bit parallel automaton (shift-and), i.e. the cost is linear in the number of samples.
+/// Decoder and automaton state persist from frame to frame only if the new frame directly continues the previous one
+/// (continuous stream without missing samples), otherwise the decoder restarts with an idle bus;
+/// the same frame fed again (new trigger parameter) is decoded with the state saved at the start of this frame.
+///
+/// Pattern syntax, tokens separated by space:
+/// - `41`, `0x41`: byte value (hex), `4?` or `0x4?`: nibble don't care, `??`: any byte
+/// - `0b0100xxxx`: byte value (binary) with don't care bits
+/// - `'A'`: character
+/// - `@50`: I2C address byte of the 7 bit address 0x50, read or write
+/// - `S`: start condition (I2C) or start of an SPI frame (clock idle before)
+class SerialTrigger {
+  public:
+    static const unsigned MAX_PATTERN = 64;     ///< max. number of pattern tokens
+    static const unsigned NOT_FOUND = UINT_MAX; ///< search() result if the pattern did not match
+
+    /// \brief Compile the pattern and reset the decoder.
+    /// \param protocol The serial protocol, OFF disables the serial trigger.
+    /// \param pattern The pattern as described above.
+    /// \param baudrate The UART bit rate.
+    /// \return false if the pattern is invalid, the serial trigger is disabled in this case.
+    bool setup( Dso::SerialProtocol protocol, const QString &pattern, unsigned baudrate );
+
+    /// \brief A valid pattern is set up.
+    bool isActive() const { return protocol != Dso::SerialProtocol::OFF && patternLength; }
+
+    /// \brief The protocol of the active pattern.
+    Dso::SerialProtocol getProtocol() const { return protocol; }
+
+    /// \brief Decode one frame and return the position of the first match inside the search window.
+    /// \param line1 UART data (trigger source) or SPI SCLK / I2C SCL (CH1).
+    /// \param line2 SPI data / I2C SDA (CH2), unused for UART (may be nullptr).
+    /// \param level1, level2 The logic threshold of both lines.
+    /// \param samplerate The samplerate of the frame.
+    /// \param first, last Search window, matches outside the window are ignored.
+    /// \param tag Identifies the frame, the same tag is decoded again with the state from the begin of the previous run.
+    /// \param continues The frame directly follows the previously decoded frame, else the decoder state is reset.
+    /// \return The sample position where the last symbol of the pattern was completed, NOT_FOUND = no match.
+    unsigned search( const std::vector< double > &line1, const std::vector< double > *line2, double level1, double level2,
+                     double samplerate, unsigned first, unsigned last, unsigned tag, bool continues );
+
+  private:
+    static const unsigned START = 256; ///< Symbol for start condition / start of frame
+
+    /// \brief Decoder and automaton state, saved at the begin of each frame.
+    struct State {
+        bool line[ 2 ] = {true, true}; ///< previous logic levels (idle high)
+        bool busy = false;             ///< UART: inside a character, SPI: inside a frame, I2C: inside a transaction
+        double countdown = 0;          ///< UART: samples until the next bit is sampled
+        unsigned bits = 0;             ///< number of received bits of the current byte
+        unsigned shift = 0;            ///< received bits of the current byte
+        unsigned sinceEdge = 0;        ///< SPI: samples since the last clock edge
+        unsigned period = 0;           ///< SPI: samples between the last two clock edges (0 = unknown)
+        uint64_t automaton = 0;        ///< active states of the shift-and automaton
+    };
+
+    /// \brief Feed one decoded symbol into the automaton.
+    /// \return true if the pattern matched with this symbol.
+    bool feed( unsigned symbol ) {
+        state.automaton = ( ( state.automaton << 1 ) | 1 ) & symbolMask[ symbol ];
+        return state.automaton & finalMask;
+    }
+
+    Dso::SerialProtocol protocol = Dso::SerialProtocol::OFF;
+    unsigned patternLength = 0;
+    uint64_t symbolMask[ START + 1 ] = {0}; ///< bit i is set if the symbol matches pattern token i
+    uint64_t finalMask = 0;                 ///< bit of the last pattern token
+    unsigned baudrate = 9600;
+    State state;
+    State frameState;        ///< state at the begin of the last frame
+    unsigned frameTag = 0;   ///< tag of the last frame
+    bool frameValid = false; ///< frameState and frameTag are set
+};
@@ -35,18 +35,22 @@
 #include "capturing.h"
 #include "dsomodel.h"
 #include "hantekdsocontrol.h"
+#include "modelregistry.h"
 #include "usb/scopedevice.h"
 
 // Post processing
+#include "post/bodegenerator.h"
 #include "post/graphgenerator.h"
 #include "post/mathchannelgenerator.h"
 #include "post/postprocessing.h"
+#include "post/rollmeasurement.h"
 #include "post/spectrumgenerator.h"
 
 // Exporter
 #include "exporting/exportcsv.h"
 #include "exporting/exporterprocessor.h"
 #include "exporting/exporterregistry.h"
+#include "exporting/exportraw.h"
 // legacy img and pdf export is replaced by MainWindow::screenshot()
 #ifdef LEGACYEXPORT
 #include "exporting/exportimage.h"
@@ -93,9 +97,12 @@ int main( int argc, char *argv[] ) {
 #endif
 
     bool demoMode = false;
+    bool simulate = false;
+    SimulationParameters simulation;
     bool useGLES = false;
     bool useGLSL120 = false;
     bool useGLSL150 = false;
+    bool useMSAA = false;
     bool useLocale = true;
     QString font = defaultFont;       // defined in viewsettings.h
     int fontSize = defaultFontSize;   // defined in viewsettings.h
@@ -115,12 +122,22 @@ int main( int argc, char *argv[] ) {
         p.addVersionOption();
         QCommandLineOption demoModeOption( {"d", "demoMode"}, "Demo mode without scope HW" );
         p.addOption( demoModeOption );
+        QCommandLineOption simulateOption( "simulate", "Simulated DSO-6022BE with USB and FIFO model (development)" );
+        p.addOption( simulateOption );
+        QCommandLineOption usbBandwidthOption(
+            "usbBandwidth", QString( "Simulated USB bandwidth in MB/s (default = %1)" ).arg( simulation.bandwidth / 1e6 ), "MBps" );
+        p.addOption( usbBandwidthOption );
+        QCommandLineOption usbJitterOption(
+            "usbJitter", QString( "Simulated random USB latency in us (default = %1)" ).arg( simulation.jitter * 1e6 ), "us" );
+        p.addOption( usbJitterOption );
         QCommandLineOption useGlesOption( {"e", "useGLES"}, "Use OpenGL ES instead of OpenGL" );
         p.addOption( useGlesOption );
         QCommandLineOption useGLSL120Option( "useGLSL120", "Force OpenGL SL version 1.20" );
         p.addOption( useGLSL120Option );
         QCommandLineOption useGLSL150Option( "useGLSL150", "Force OpenGL SL version 1.50" );
         p.addOption( useGLSL150Option );
+        QCommandLineOption useMSAAOption( "useMSAA", "Use 4x multisample antialiasing (slow on weak GPUs)" );
+        p.addOption( useMSAAOption );
         QCommandLineOption intOption( {"i", "international"}, "Show the international interface, do not translate" );
         p.addOption( intOption );
         QCommandLineOption fontOption( {"f", "font"}, "Define the system font", "Font" );
@@ -133,6 +150,11 @@ int main( int argc, char *argv[] ) {
         p.addOption( condensedOption );
         p.process( parserApp );
         demoMode = p.isSet( demoModeOption );
+        simulate = p.isSet( simulateOption ) && !demoMode;
+        if ( p.isSet( usbBandwidthOption ) )
+            simulation.bandwidth = qMax( p.value( usbBandwidthOption ).toDouble(), 0.1 ) * 1e6;
+        if ( p.isSet( usbJitterOption ) )
+            simulation.jitter = qMax( p.value( usbJitterOption ).toDouble(), 0.0 ) * 1e-6;
         useGLES = p.isSet( useGlesOption );
         if ( p.isSet( fontOption ) )
             font = p.value( "font" );
@@ -142,6 +164,7 @@ int main( int argc, char *argv[] ) {
             condensed = qBound( 50, p.value( "condensed" ).toInt(), 200 );
         useGLSL120 = p.isSet( useGLSL120Option );
         useGLSL150 = p.isSet( useGLSL150Option );
+        useMSAA = p.isSet( useMSAAOption );
         useLocale = !p.isSet( intOption );
     } // ... and forget the no more needed variables
 
@@ -150,7 +173,7 @@ int main( int argc, char *argv[] ) {
     useGLES = true;
 #endif
 
-    GlScope::useQSurfaceFormat( useGLES ? QSurfaceFormat::OpenGLES : QSurfaceFormat::OpenGL );
+    GlScope::useQSurfaceFormat( useGLES ? QSurfaceFormat::OpenGLES : QSurfaceFormat::OpenGL, useMSAA );
     if ( useGLSL120 )
         GlScope::useOpenGLSLversion( 120 );
     else if ( useGLSL150 )
@@ -195,7 +218,14 @@ int main( int argc, char *argv[] ) {
 
     std::unique_ptr< ScopeDevice > scopeDevice = nullptr;
 
-    if ( !demoMode ) {
+    if ( simulate ) { // the real protocol without USB, see SimulatedFX2
+        for ( DSOModel *model : ModelRegistry::get()->models() )
+            if ( model->name == "DSO-6022BE" )
+                scopeDevice = std::unique_ptr< ScopeDevice >( new ScopeDevice( model, simulation ) );
+        QString errorMessage;
+        if ( scopeDevice == nullptr || !scopeDevice->connectDevice( errorMessage ) )
+            return -1;
+    } else if ( !demoMode ) {
         int error = libusb_init( &context );
         if ( error ) {
             SelectSupportedDevice().showLibUSBFailedDialogModel( error );
@@ -247,7 +277,10 @@ int main( int argc, char *argv[] ) {
     ExporterRegistry exportRegistry( spec, &settings );
     ExporterCSV exporterCSV;
     ExporterProcessor samplesToExportRaw( &exportRegistry );
+    ExporterRaw exporterRaw;
     exportRegistry.registerExporter( &exporterCSV );
+    exportRegistry.registerExporter( &exporterRaw );
+    QObject::connect( &exportRegistry, &ExporterRegistry::rawRecordingChanged, &dsoControl, &HantekDsoControl::setRawRecording );
 
     //////// Create post processing objects ////////
     QThread postProcessingThread;
@@ -256,11 +289,15 @@ int main( int argc, char *argv[] ) {
 
     SpectrumGenerator spectrumGenerator( &settings.scope, &settings.post );
     MathChannelGenerator mathchannelGenerator( &settings.scope, spec->channels );
+    RollMeasurement rollMeasurement( &settings.scope, &settings.post );
+    BodeGenerator bodeGenerator( &settings.scope, &settings.post, spec->channels );
     GraphGenerator graphGenerator( &settings.scope, &settings.view );
 
     postProcessing.registerProcessor( &samplesToExportRaw );
     postProcessing.registerProcessor( &mathchannelGenerator );
     postProcessing.registerProcessor( &spectrumGenerator );
+    postProcessing.registerProcessor( &rollMeasurement ); // replaces the measurements of spectrumGenerator
+    postProcessing.registerProcessor( &bodeGenerator );   // replaces the math spectrum of spectrumGenerator
     postProcessing.registerProcessor( &graphGenerator );
 
     postProcessing.moveToThread( &postProcessingThread );
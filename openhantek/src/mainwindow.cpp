@@ -84,6 +84,8 @@ MainWindow::MainWindow( HantekDsoControl *dsoControl, DsoSettings *settings, Exp
                               .arg( QString::fromStdString( VERSION ), dsoControl->getModel()->name )
                               .arg( dsoControl->getDevice()->getFwVersion(), 4, 16, QChar( '0' ) )
                         : tr( "OpenHantek6022 (%1) - " ).arg( QString::fromStdString( VERSION ) ) + tr( "Demo Mode" ) );
+    if ( dsoControl->getDevice()->isSimulated() )
+        setWindowTitle( windowTitle() + tr( " - Simulation" ) );
 
 #if ( QT_VERSION >= QT_VERSION_CHECK( 5, 6, 0 ) )
     setDockOptions( dockOptions() | QMainWindow::GroupedDragging );
@@ -130,7 +132,7 @@ MainWindow::MainWindow( HantekDsoControl *dsoControl, DsoSettings *settings, Exp
     // Docking windows
     // Create dock windows before the dso widget, they fix messed up settings
 
-    VoltageDock *voltageDock = new VoltageDock( scope, spec, this );
+    voltageDock = new VoltageDock( scope, spec, this );
     HorizontalDock *horizontalDock = new HorizontalDock( scope, spec, this );
     TriggerDock *triggerDock = new TriggerDock( scope, spec, this );
     SpectrumDock *spectrumDock = new SpectrumDock( scope, this );
@@ -153,6 +155,12 @@ MainWindow::MainWindow( HantekDsoControl *dsoControl, DsoSettings *settings, Exp
 
     statusBar()->addPermanentWidget( commandEdit, 1 );
 
+    // Cancel button for the background exports inside the status bar
+    cancelExportButton = new QPushButton( tr( "Cancel export" ), this );
+    cancelExportButton->hide();
+    statusBar()->addPermanentWidget( cancelExportButton );
+    connect( cancelExportButton, &QAbstractButton::clicked, exporterRegistry, &ExporterRegistry::cancelExports );
+
     connect( ui->actionManualCommand, &QAction::toggled, [this]( bool checked ) {
         commandEdit->setVisible( checked );
         if ( checked )
@@ -181,6 +189,7 @@ MainWindow::MainWindow( HantekDsoControl *dsoControl, DsoSettings *settings, Exp
     } );
     connect( spectrumDock, &SpectrumDock::frequencybaseChanged,
              [this]( double frequencybase ) { this->dsoWidget->updateFrequencybase( frequencybase ); } );
+    connect( spectrumDock, &SpectrumDock::spectrumAcquisitionChanged, dsoControl, &HantekDsoControl::setSpectrumAcquisition );
     connect( dsoControl, &HantekDsoControl::samplerateChanged, [this, horizontalDock, spectrumDock]( double samplerate ) {
         // The timebase was set, let's adapt the samplerate accordingly
         // printf( "mainwindow::samplerateChanged( %g )\n", samplerate );
@@ -210,6 +219,7 @@ MainWindow::MainWindow( HantekDsoControl *dsoControl, DsoSettings *settings, Exp
     // should we send the smooth mode also to dsoWidget?
     connect( triggerDock, &TriggerDock::slopeChanged, dsoControl, &HantekDsoControl::setTriggerSlope );
     connect( triggerDock, &TriggerDock::slopeChanged, dsoWidget, &DsoWidget::updateTriggerSlope );
+    connect( triggerDock, &TriggerDock::serialChanged, dsoControl, &HantekDsoControl::setSerialTrigger );
     connect( dsoWidget, &DsoWidget::triggerPositionChanged, dsoControl, &HantekDsoControl::setTriggerOffset );
     connect( dsoWidget, &DsoWidget::triggerLevelChanged, dsoControl, &HantekDsoControl::setTriggerLevel );
 
@@ -227,6 +237,9 @@ MainWindow::MainWindow( HantekDsoControl *dsoControl, DsoSettings *settings, Exp
             for ( ChannelID c = 0; c < spec->channels; ++c )
                 dsoControl->setChannelUsed( c, mathUsed | dsoSettings->scope.anyUsed( c ) );
         }
+        // spectrum acquisition is active only without voltage channels
+        dsoControl->setSpectrumAcquisition( dsoSettings->scope.horizontal.spectrumAcquisition, dsoSettings->scope.horizontal.span,
+                                            dsoSettings->scope.horizontal.rbw );
     };
     connect( voltageDock, &VoltageDock::usedChanged, usedChanged );
     connect( spectrumDock, &SpectrumDock::usedChanged, usedChanged );
@@ -327,11 +340,18 @@ MainWindow::MainWindow( HantekDsoControl *dsoControl, DsoSettings *settings, Exp
 
     connect( ui->actionExit, &QAction::triggered, this, &QWidget::close );
 
-    connect( ui->actionSettings, &QAction::triggered, [this]() {
+    connect( ui->actionSettings, &QAction::triggered, [this, dsoControl, spec]() {
         dsoSettings->mainWindowGeometry = saveGeometry();
         dsoSettings->mainWindowState = saveState();
 
         DsoConfigDialog *configDialog = new DsoConfigDialog( this->dsoSettings, this );
+        connect( configDialog, &DsoConfigDialog::settingsApplied, [this, dsoControl, spec]() {
+            for ( ChannelID channel = 0; channel < spec->channels; ++channel ) {
+                dsoControl->setSensor( channel, dsoSettings->scope.voltage[ channel ].sensor );
+                dsoWidget->updateVoltageGain( channel ); // the sensor changes the unit/div
+            }
+            dsoControl->setDualTimebase( dsoSettings->scope.horizontal.dualTimebase && dsoSettings->view.zoom );
+        } );
         configDialog->setModal( true );
         configDialog->show();
     } );
@@ -357,8 +377,9 @@ MainWindow::MainWindow( HantekDsoControl *dsoControl, DsoSettings *settings, Exp
     ui->actionHistogram->setChecked( dsoSettings->scope.histogram );
     ui->actionHistogram->setEnabled( scope->horizontal.format == Dso::GraphFormat::TY );
 
-    connect( ui->actionZoom, &QAction::toggled, [this]( bool enabled ) {
+    connect( ui->actionZoom, &QAction::toggled, [this, dsoControl]( bool enabled ) {
         dsoSettings->view.zoom = enabled;
+        dsoControl->setDualTimebase( dsoSettings->scope.horizontal.dualTimebase && enabled );
 
         if ( dsoSettings->view.zoom )
             this->ui->actionZoom->setStatusTip( tr( "Hide magnified scope" ) );
@@ -429,13 +450,23 @@ MainWindow::MainWindow( HantekDsoControl *dsoControl, DsoSettings *settings, Exp
 
 MainWindow::~MainWindow() { delete ui; }
 
-void MainWindow::showNewData( std::shared_ptr< PPresult > newData ) { dsoWidget->showNew( newData ); }
+void MainWindow::showNewData( std::shared_ptr< PPresult > newData ) {
+    if ( !newData->detail )                      // dual timebase: use only the overview frames
+        voltageDock->autoRange( newData.get() ); // adapt the gain for the next frames
+    dsoWidget->showNew( newData );
+}
 
 void MainWindow::exporterStatusChanged( const QString &exporterName, const QString &status ) {
     ui->statusbar->showMessage( tr( "%1: %2" ).arg( exporterName, status ) );
 }
 
-void MainWindow::exporterProgressChanged() { exporterRegistry->checkForWaitingExporters(); }
+void MainWindow::exporterProgressChanged() {
+    exporterRegistry->checkForWaitingExporters();
+    const float progress = exporterRegistry->exportProgress();
+    if ( progress >= 0 )
+        ui->statusbar->showMessage( tr( "Saving data .. %1%" ).arg( int( progress * 100 ) ) );
+    cancelExportButton->setVisible( progress >= 0 );
+}
 
 // make screenshot (type == SCREENSHOT) from the complete program window with screen colors ...
 // ... or a printable hardcopy (type == HARDCOPY) from the scope widget only ...
@@ -5,6 +5,7 @@
 #include <QElapsedTimer>
 #include <QLineEdit>
 #include <QMainWindow>
+#include <QPushButton>
 #include <memory>
 
 #include "scopesettings.h"
@@ -48,9 +49,11 @@ class MainWindow : public QMainWindow {
     QIcon iconPause;
     QIcon iconPlay;
     QLineEdit *commandEdit;
+    QPushButton *cancelExportButton; // shown while an export is written in the background
 
     // Central widgets
     DsoWidget *dsoWidget;
+    VoltageDock *voltageDock;
 
     // Settings used for the whole program
     DsoSettings *dsoSettings;
@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+#include <cmath>
+
+#include "bodegenerator.h"
+#include "post/postprocessingsettings.h"
+#include "scopesettings.h"
+
+// frequency resolution = samplerate / segment length, shorter records use shorter segments
+static const unsigned BODE_SEGMENT_MAX = 4096;
+static const unsigned BODE_SEGMENT_MIN = 64;
+// the averages behave like a moving average over this number of segments
+static const unsigned BODE_AVERAGES = 256;
+// bins with a lower coherence are dominated by noise or missing stimulus and are not shown
+static const double BODE_COHERENCE_MIN = 0.5;
+
+
+BodeGenerator::BodeGenerator( const DsoSettingsScope *scope, const DsoSettingsPostProcessing *postprocessing,
+                              unsigned physicalChannels )
+    : scope( scope ), postprocessing( postprocessing ), physicalChannels( physicalChannels ) {}
+
+
+BodeGenerator::~BodeGenerator() { destroyPlan(); }
+
+
+void BodeGenerator::destroyPlan() {
+    if ( forward )
+        fftw_destroy_plan( forward );
+    fftw_free( segmentIn ); // fftw_free( nullptr ) is a no-op
+    fftw_free( spectrumX );
+    fftw_free( spectrumY );
+    forward = nullptr;
+    segmentIn = nullptr;
+    spectrumX = nullptr;
+    spectrumY = nullptr;
+    segmentLength = 0;
+}
+
+
+void BodeGenerator::updatePlan( unsigned length ) {
+    if ( length == segmentLength )
+        return;
+    destroyPlan();
+    segmentLength = length;
+    // FFTW_ESTIMATE: planning is fast and does not touch the buffers
+    // both output buffers are allocated by fftw with the same alignment, as required by fftw_execute_dft_r2c()
+    segmentIn = fftw_alloc_real( length );
+    spectrumX = fftw_alloc_complex( length / 2 + 1 );
+    spectrumY = fftw_alloc_complex( length / 2 + 1 );
+    forward = fftw_plan_dft_r2c_1d( int( length ), segmentIn, spectrumX, FFTW_ESTIMATE );
+    window.resize( length );
+    for ( unsigned position = 0; position < length; ++position ) // periodic Hann window, sums up to 1 with 50% overlap
+        window[ position ] = 0.5 * ( 1.0 - cos( 2.0 * M_PI * position / length ) );
+    restart();
+}
+
+
+void BodeGenerator::restart() {
+    const size_t bins = segmentLength / 2 + 1;
+    sxx.assign( bins, 0.0 );
+    syy.assign( bins, 0.0 );
+    sxyRe.assign( bins, 0.0 );
+    sxyIm.assign( bins, 0.0 );
+    averages = 0;
+    total = -1;
+}
+
+
+void BodeGenerator::process( PPresult *result ) {
+    if ( physicalChannels < 2 || ( !scope->voltage[ physicalChannels ].used && !scope->spectrum[ physicalChannels ].used ) ||
+         Dso::getMathMode( scope->voltage[ physicalChannels ] ) != Dso::MathMode::BODE_CH1_CH2 ) {
+        if ( segmentLength )
+            destroyPlan(); // release the memory while not used
+        return;
+    }
+    if ( result->detail ) // dual timebase: keep the averages of the overview samplerate
+        return;
+    // ROI mode: use the whole record if available, more segments per frame
+    const DataChannel *input = result->data( 0 );
+    const DataChannel *output = result->data( 1 );
+    const std::vector< double > &x = input->record.sample.empty() ? input->voltage.sample : input->record.sample;
+    const std::vector< double > &y = output->record.sample.empty() ? output->voltage.sample : output->record.sample;
+    const size_t count = std::min( x.size(), y.size() );
+    // at least 3 segments per frame, power of two length
+    unsigned length = BODE_SEGMENT_MAX;
+    while ( length > BODE_SEGMENT_MIN && length * 2 > count )
+        length /= 2;
+    if ( count < length || input->voltage.interval <= 0 )
+        return;
+    updatePlan( length );
+    if ( input->voltage.interval != interval ) { // new samplerate, the old bins have other frequencies
+        interval = input->voltage.interval;
+        restart();
+    }
+
+    // only new samples are averaged, otherwise the same data gets a higher weight with every frame
+    const unsigned hop = length / 2;
+    size_t first = 0;
+    size_t end = count;
+    if ( result->rollTotal >= 0 ) {
+        // roll mode: the screen is shifted by the samples that arrived since the previous frame (see RollMeasurement),
+        // the segments start at stream positions that are multiples of the hop size and each one is added once
+        const int64_t streamFirst = result->rollTotal - int64_t( count ); // stream position of x[ 0 ]
+        int64_t start = streamFirst;
+        if ( total >= 0 && result->rollTotal >= total ) // continue after the last segment that was complete
+            start = std::max( total - int64_t( length ) + 1, streamFirst );
+        start = std::max( start, int64_t( 0 ) );
+        start = ( start + hop - 1 ) / hop * hop;
+        first = size_t( std::min( start - streamFirst, int64_t( count ) ) );
+        total = result->rollTotal;
+    } else {
+        total = -1;
+        if ( scope->trigger.mode == Dso::TriggerMode::NORMAL && !result->softwareTriggerTriggered )
+            end = 0; // the last triggered trace is shown again, keep the averages unchanged
+    }
+
+    // add the cross and auto spectra of the new segments of this frame to the averages:
+    // mean over the first BODE_AVERAGES segments, then exponential decay of the older segments
+    const size_t bins = length / 2 + 1;
+    for ( ; first + length <= end; first += hop ) {
+        // remove the DC of the segment, it would leak into the low frequency bins
+        double xDc = 0.0;
+        double yDc = 0.0;
+        for ( unsigned position = 0; position < length; ++position ) {
+            xDc += x[ first + position ];
+            yDc += y[ first + position ];
+        }
+        xDc /= length;
+        yDc /= length;
+        for ( unsigned position = 0; position < length; ++position )
+            segmentIn[ position ] = window[ position ] * ( x[ first + position ] - xDc );
+        fftw_execute_dft_r2c( forward, segmentIn, spectrumX );
+        for ( unsigned position = 0; position < length; ++position )
+            segmentIn[ position ] = window[ position ] * ( y[ first + position ] - yDc );
+        fftw_execute_dft_r2c( forward, segmentIn, spectrumY );
+        averages = std::min( averages + 1, BODE_AVERAGES );
+        const double weight = 1.0 / averages;
+        for ( size_t bin = 0; bin < bins; ++bin ) {
+            const double xRe = spectrumX[ bin ][ 0 ];
+            const double xIm = spectrumX[ bin ][ 1 ];
+            const double yRe = spectrumY[ bin ][ 0 ];
+            const double yIm = spectrumY[ bin ][ 1 ];
+            sxx[ bin ] += weight * ( xRe * xRe + xIm * xIm - sxx[ bin ] );
+            syy[ bin ] += weight * ( yRe * yRe + yIm * yIm - syy[ bin ] );
+            sxyRe[ bin ] += weight * ( xRe * yRe + xIm * yIm - sxyRe[ bin ] ); // X* Y
+            sxyIm[ bin ] += weight * ( xRe * yIm - xIm * yRe - sxyIm[ bin ] );
+        }
+    }
+
+    // H = Sxy / Sxx, the magnitude in dB replaces the spectrum of the math channel
+    FrequencyResponse &bode = result->bode;
+    DataChannel *const mathData = result->modifiableData( physicalChannels );
+    const double limit = postprocessing->spectrumLimit - postprocessing->spectrumReference; // bottom of the spectrum
+    mathData->spectrum.interval = bode.interval = 1.0 / ( interval * length );
+    mathData->spectrum.sample.resize( bins );
+    bode.phase.resize( bins );
+    bode.coherence.resize( bins );
+    bode.averages = averages;
+    for ( size_t bin = 0; bin < bins; ++bin ) {
+        const double cross = sxyRe[ bin ] * sxyRe[ bin ] + sxyIm[ bin ] * sxyIm[ bin ]; // |Sxy|²
+        const double power = sxx[ bin ] * syy[ bin ];
+        bode.coherence[ bin ] = power > 0 ? std::min( cross / power, 1.0 ) : 0.0;
+        bode.phase[ bin ] = atan2( sxyIm[ bin ], sxyRe[ bin ] ) * 180 / M_PI;
+        double magnitude = limit;
+        if ( sxx[ bin ] > 0 && cross > 0 && bode.coherence[ bin ] >= BODE_COHERENCE_MIN )
+            magnitude = std::max( 10 * log10( cross / ( sxx[ bin ] * sxx[ bin ] ) ), limit ); // 20 * log10( |Sxy| / Sxx )
+        mathData->spectrum.sample[ bin ] = magnitude;
+    }
+    // values at the stimulus frequency for the measurement display
+    const size_t stimulus = size_t( round( input->frequency / bode.interval ) );
+    if ( stimulus > 0 && stimulus < bins ) {
+        bode.gain = mathData->spectrum.sample[ stimulus ];
+        bode.phaseShift = bode.phase[ stimulus ];
+        bode.coherenceValue = bode.coherence[ stimulus ];
+    }
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <cstdint>
+#include <fftw3.h>
+#include <vector>
+
+#include "processor.h"
+
+struct DsoSettingsScope;
+struct DsoSettingsPostProcessing;
+class PPresult;
+
+/// \brief Bode mode: estimates the transfer function of a device under test with CH1 as input and CH2 as output.
+/// H(f) = Sxy(f) / Sxx(f) and the coherence |Sxy|² / ( Sxx * Syy ) are calculated from the cross and auto spectra
+/// of Hann windowed, 50% overlapping segments (Welch), averaged over the segments of all following frames.
+/// A broadband stimulus (noise, chirp, square wave) gives the full frequency response after a few frames.
+/// The averages decay exponentially, the memory is fixed by the segment length.
+class BodeGenerator : public Processor {
+
+  public:
+    BodeGenerator( const DsoSettingsScope *scope, const DsoSettingsPostProcessing *postprocessing, unsigned physicalChannels );
+    ~BodeGenerator() override;
+    void process( PPresult * ) override;
+
+  private:
+    const DsoSettingsScope *scope;
+    const DsoSettingsPostProcessing *postprocessing;
+    const unsigned physicalChannels;
+    // the plan, buffers and window are reused as long as the segment length does not change
+    unsigned segmentLength = 0;
+    double *segmentIn = nullptr;        ///< windowed segment of CH1 or CH2
+    fftw_complex *spectrumX = nullptr;  ///< one-sided spectrum of the CH1 segment
+    fftw_complex *spectrumY = nullptr;  ///< one-sided spectrum of the CH2 segment
+    fftw_plan forward = nullptr;        ///< segmentIn -> spectrumX, executed also for spectrumY (new-array execute)
+    std::vector< double > window;       ///< Hann window of the segment length
+    // averaged cross and auto spectra, one value per bin
+    std::vector< double > sxx;          ///< |X|²
+    std::vector< double > syy;          ///< |Y|²
+    std::vector< double > sxyRe;        ///< Re( X* Y )
+    std::vector< double > sxyIm;        ///< Im( X* Y )
+    unsigned averages = 0;              ///< number of segments in the averages (limited to BODE_AVERAGES)
+    double interval = 0.0;              ///< sample interval of the averages, a change restarts the averaging
+    int64_t total = -1;                 ///< roll mode: rollTotal of the previous frame, -1 = not rolling
+    void updatePlan( unsigned length );
+    void destroyPlan();
+    void restart();
+};
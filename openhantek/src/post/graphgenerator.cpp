@@ -6,6 +6,7 @@
 
 #include "graphgenerator.h"
 #include "hantekdso/controlspecification.h"
+#include "postprocessingsettings.h"
 #include "ppresult.h"
 #include "scopesettings.h"
 #include "utils/printutils.h"
@@ -35,6 +36,20 @@ GraphGenerator::GraphGenerator( const DsoSettingsScope *scope, const DsoSettings
 }
 
 
+bool GraphGenerator::useRollGraph( const PPresult *result, const DsoSettingsScope *scope, const DsoSettingsView *view,
+                                   ChannelID channel ) {
+    if ( result->rollTotal < 0 || scope->horizontal.format != Dso::GraphFormat::TY || scope->histogram ||
+         view->digitalPhosphor || view->interpolation > Dso::INTERPOLATION_LINEAR )
+        return false;
+    if ( channel >= scope->voltage.size() || !scope->voltage[ channel ].used || !result->data( channel ) ||
+         result->data( channel )->voltage.sample.empty() )
+        return false;
+    // "AC" math is calculated from the complete record, the samples change with each frame
+    const ChannelID mathChannel = ChannelID( scope->voltage.size() - 1 );
+    return channel != mathChannel || Dso::getMathMode( scope->voltage[ mathChannel ] ) < Dso::MathMode::AC_CH1;
+}
+
+
 void GraphGenerator::prepareSinc( void ) {
     // prepare a sinc table (without sinc(0))
     sinc.clear();
@@ -72,7 +87,8 @@ void GraphGenerator::generateGraphsTYvoltage( PPresult *result ) {
         const SampleValues &samples = useVoltSamplesOf( channel, result, scope );
 
         // Check if this channel is used and available at the data analyzer
-        if ( samples.sample.empty() ) {
+        // or if the GPU roll renderer shows this channel, spectrum acquisition has no time domain graphs
+        if ( result->spectrumOnly || samples.sample.empty() || useRollGraph( result, scope, view, channel ) ) {
             // Delete all vector arrays
             graphVoltage.clear();
             graphHistogram.clear();
@@ -98,7 +114,9 @@ void GraphGenerator::generateGraphsTYvoltage( PPresult *result ) {
         const unsigned binsPerDiv = 50; // resolution of histogram
 
         // Set size directly to avoid reallocations (n+1 dots to display n lines)
-        graphVoltage.reserve( ++dotsOnScreen * ( interpolationStep ? 2 : 1 ) ); // two dots per "Step"
+        // a dual timebase detail frame covers only the zoomed part of the screen
+        const unsigned dotsAvailable = std::min( ++dotsOnScreen, unsigned( samples.sample.size() ) );
+        graphVoltage.reserve( dotsAvailable * ( interpolationStep ? 2 : 1 ) ); // two dots per "Step"
         graphHistogram.reserve( int( 2 * ( binsPerDiv * DIVS_VOLTAGE ) ) );
 
         const double gain = scope->gain( channel );
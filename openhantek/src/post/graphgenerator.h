@@ -25,6 +25,10 @@ class GraphGenerator : public QObject, public Processor {
   public:
     GraphGenerator( const DsoSettingsScope *scope, const DsoSettingsView *view );
 
+    /// \brief Roll mode traces are not generated here, GlScope appends the new samples to a circular GPU buffer.
+    static bool useRollGraph( const PPresult *result, const DsoSettingsScope *scope, const DsoSettingsView *view,
+                              ChannelID channel );
+
   private:
     void generateGraphsTYvoltage( PPresult *result );
     void generateGraphsTYspectrum( PPresult *result );
@@ -1,5 +1,9 @@
 // SPDX-License-Identifier: GPL-2.0+
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #include "mathchannelgenerator.h"
 #include "enums.h"
 #include "post/postprocessingsettings.h"
@@ -9,7 +13,59 @@ MathChannelGenerator::MathChannelGenerator( const DsoSettingsScope *scope, unsig
     : physicalChannels( physicalChannels ), scope( scope ) {}
 
 
-MathChannelGenerator::~MathChannelGenerator() {}
+MathChannelGenerator::~MathChannelGenerator() { destroyHilbertPlans(); }
+
+
+void MathChannelGenerator::destroyHilbertPlans() {
+    if ( hilbertForward )
+        fftw_destroy_plan( hilbertForward );
+    if ( hilbertInverse )
+        fftw_destroy_plan( hilbertInverse );
+    fftw_free( hilbertIn ); // fftw_free( nullptr ) is a no-op
+    fftw_free( hilbertSpectrum );
+    fftw_free( hilbertOut );
+    hilbertForward = nullptr;
+    hilbertInverse = nullptr;
+    hilbertIn = nullptr;
+    hilbertSpectrum = nullptr;
+    hilbertOut = nullptr;
+    hilbertLength = 0;
+}
+
+
+void MathChannelGenerator::updateHilbertPlans( unsigned sampleCount ) {
+    if ( sampleCount == hilbertLength )
+        return;
+    destroyHilbertPlans();
+    hilbertLength = sampleCount;
+    // FFTW_ESTIMATE: planning is fast and does not touch the buffers
+    hilbertIn = fftw_alloc_real( sampleCount );
+    hilbertSpectrum = fftw_alloc_complex( sampleCount );
+    hilbertOut = fftw_alloc_complex( sampleCount );
+    // real -> one-sided spectrum (bins 0 .. n/2), complex spectrum -> complex time signal
+    hilbertForward = fftw_plan_dft_r2c_1d( int( sampleCount ), hilbertIn, hilbertSpectrum, FFTW_ESTIMATE );
+    hilbertInverse = fftw_plan_dft_1d( int( sampleCount ), hilbertSpectrum, hilbertOut, FFTW_BACKWARD, FFTW_ESTIMATE );
+}
+
+
+// Calculate the analytic signal of "samples" into "hilbertOut" (scaled by the sample count):
+// Z(f) = X(f) for f = 0 and f = fs/2, 2 * X(f) for 0 < f < fs/2 and 0 for the negative frequencies.
+// Re( z ) is the original signal, Im( z ) its Hilbert transform; one r2c and one c2c transform, O( n log n ).
+void MathChannelGenerator::analyticSignal( const std::vector< double > &samples ) {
+    const unsigned sampleCount = unsigned( samples.size() );
+    updateHilbertPlans( sampleCount );
+    std::copy( samples.begin(), samples.end(), hilbertIn );
+    fftw_execute( hilbertForward );
+    const unsigned half = sampleCount / 2; // the Nyquist bin (only if sampleCount is even)
+    for ( unsigned bin = 1; bin < ( sampleCount + 1 ) / 2; ++bin ) {
+        hilbertSpectrum[ bin ][ 0 ] *= 2;
+        hilbertSpectrum[ bin ][ 1 ] *= 2;
+    }
+    const unsigned firstNegative = half + 1;
+    if ( sampleCount > firstNegative )
+        memset( hilbertSpectrum + firstNegative, 0, ( sampleCount - firstNegative ) * sizeof( fftw_complex ) );
+    fftw_execute( hilbertInverse );
+}
 
 
 void MathChannelGenerator::process( PPresult *result ) {
@@ -56,6 +112,62 @@ void MathChannelGenerator::process( PPresult *result ) {
         for ( auto it = resultData.begin(), end = resultData.end(); it != end; ++it ) {
             *it = sign * calculate( *ch1Iterator++, *ch2Iterator++ );
         }
+    } else if ( Dso::getMathMode( scope->voltage[ physicalChannels ] ) == Dso::MathMode::BODE_CH1_CH2 ) {
+        // transfer function: the trace shows the response CH2, BodeGenerator replaces the spectrum with H(f)
+        channelData->voltage.interval = result->data( 1 )->voltage.interval;
+        resultData.resize( result->data( 1 )->voltage.sample.size() );
+        auto srcIt = result->data( 1 )->voltage.sample.begin();
+        for ( auto dstIt = resultData.begin(), dstEnd = resultData.end(); dstIt != dstEnd; ++srcIt, ++dstIt )
+            *dstIt = sign * *srcIt;
+    } else if ( Dso::getMathMode( scope->voltage[ physicalChannels ] ) >= Dso::MathMode::ENVELOPE_CH1 ) { // demodulation
+        const Dso::MathMode mode = Dso::getMathMode( scope->voltage[ physicalChannels ] );
+        // CH1, CH2, CH1, CH2, ...
+        const unsigned src = ( unsigned( mode ) - unsigned( Dso::MathMode::ENVELOPE_CH1 ) ) % 2;
+        const std::vector< double > &samples = result->data( src )->voltage.sample;
+        if ( samples.size() < 2 ) {
+            resultData.clear();
+            return;
+        }
+        const double interval = result->data( src )->voltage.interval;
+        channelData->voltage.interval = interval;
+        resultData.resize( samples.size() );
+
+        analyticSignal( samples );
+        const double scale = 1.0 / samples.size(); // fftw does not normalise the inverse transform
+        const fftw_complex *z = hilbertOut;
+        switch ( mode ) {
+        case Dso::MathMode::ENVELOPE_CH1:
+        case Dso::MathMode::ENVELOPE_CH2:
+            // AM demodulation: |z|
+            for ( unsigned index = 0; index < resultData.size(); ++index )
+                resultData[ index ] = sign * scale * hypot( z[ index ][ 0 ], z[ index ][ 1 ] );
+            break;
+        case Dso::MathMode::PHASE_CH1:
+        case Dso::MathMode::PHASE_CH2:
+            // instantaneous phase -pi .. pi (rad)
+            for ( unsigned index = 0; index < resultData.size(); ++index )
+                resultData[ index ] = sign * atan2( z[ index ][ 1 ], z[ index ][ 0 ] );
+            break;
+        default: {
+            // FM demodulation: f = d(phase)/dt / 2pi, the phase step is arg( z[n] * conj( z[n-1] ) ),
+            // this needs no phase unwrapping and is valid as long as the step is below pi, i.e. f < fs/2
+            const double toHertz = 1.0 / ( 2 * M_PI * interval );
+            double mean = 0;
+            for ( unsigned index = 1; index < resultData.size(); ++index ) {
+                const double re = z[ index ][ 0 ] * z[ index - 1 ][ 0 ] + z[ index ][ 1 ] * z[ index - 1 ][ 1 ];
+                const double im = z[ index ][ 1 ] * z[ index - 1 ][ 0 ] - z[ index ][ 0 ] * z[ index - 1 ][ 1 ];
+                resultData[ index ] = toHertz * atan2( im, re );
+                mean += resultData[ index ];
+            }
+            mean /= resultData.size() - 1;
+            resultData[ 0 ] = resultData[ 1 ];
+            // show the deviation from the carrier, the carrier itself is off screen, trace scale see Dso::mathModeScale()
+            const double toTrace = sign / Dso::mathModeScale( mode );
+            for ( double &value : resultData )
+                value = toTrace * ( value - mean );
+            break;
+        }
+        }
     } else { // unary operators (calculate "AC coupling")
         unsigned src = 0;
         if ( Dso::getMathMode( scope->voltage[ physicalChannels ] ) == Dso::MathMode::AC_CH1 )
@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include <fftw3.h>
+#include <vector>
+
 #include "processor.h"
 
 struct DsoSettingsScope;
@@ -17,4 +20,15 @@ class MathChannelGenerator : public Processor {
   private:
     const unsigned physicalChannels;
     const DsoSettingsScope *scope;
+    // Analytic signal z(t) = x(t) + j * hilbert( x(t) ), calculated via FFT
+    // the plans and buffers are reused as long as the record length does not change
+    unsigned hilbertLength = 0;
+    double *hilbertIn = nullptr;             ///< real input samples
+    fftw_complex *hilbertSpectrum = nullptr; ///< one-sided spectrum, negative frequencies are zero
+    fftw_complex *hilbertOut = nullptr;      ///< the (unscaled) analytic signal
+    fftw_plan hilbertForward = nullptr;
+    fftw_plan hilbertInverse = nullptr;
+    void updateHilbertPlans( unsigned sampleCount );
+    void destroyHilbertPlans();
+    void analyticSignal( const std::vector< double > &samples );
 };
@@ -15,7 +15,7 @@ void PostProcessing::convertData( const DSOsamples *source, PPresult *destinatio
     QReadLocker locker( &source->lock );
     if ( source->triggeredPosition ) {
         destination->softwareTriggerTriggered = source->liveTrigger;
-        destination->triggeredPosition = source->triggeredPosition;
+        destination->triggeredPosition = source->triggeredPosition - qMin( source->roiFirst, source->triggeredPosition );
         destination->pulseWidth1 = source->pulseWidth1;
         destination->pulseWidth2 = source->pulseWidth2;
     } else {
@@ -33,11 +33,33 @@ void PostProcessing::convertData( const DSOsamples *source, PPresult *destinatio
         }
         DataChannel *const channelData = destination->modifiableData( channel );
         channelData->voltage.interval = 1.0 / source->samplerate;
-        channelData->voltage.sample = rawChannelData;
+        if ( source->roiCount ) { // ROI mode: copy only the displayed window plus margins
+            const size_t first = qMin( size_t( source->roiFirst ), rawChannelData.size() );
+            const size_t last = qMin( first + source->roiCount, rawChannelData.size() );
+            channelData->voltage.sample.assign( rawChannelData.begin() + long( first ), rawChannelData.begin() + long( last ) );
+            if ( source->roiSpectrumRecord ) {
+                channelData->record.interval = channelData->voltage.interval;
+                channelData->record.sample = rawChannelData;
+            }
+        } else {
+            channelData->voltage.sample = rawChannelData;
+        }
         // printf( "PP CH%d: %d\n", channel+1, source->clipped );
         channelData->valid = !( source->clipped & ( 0x01 << channel ) );
+        channelData->inputPeak = channel < 2 ? source->inputPeak[ channel ] : -1.0;
     }
     destination->tag = source->tag;
+    destination->roiFirst = source->roiCount ? source->roiFirst : 0;
+    destination->roiCount = source->roiCount;
+    destination->rollTotal = source->rollTotal;
+    destination->detail = source->detail;
+    destination->hasDetail = source->hasDetail;
+    destination->spectrumOnly = source->spectrumOnly;
+    destination->requestTime = source->requestTime;
+    destination->completionTime = source->completionTime;
+    destination->deadTime = source->deadTime;
+    destination->dutyCycle = source->dutyCycle;
+    destination->rawFrame = source->rawFrame;
 }
 
 
@@ -7,7 +7,7 @@
 
 namespace Dso {
 
-Enum< Dso::MathMode, Dso::MathMode::ADD_CH1_CH2, Dso::MathMode::AC_CH2 > MathModeEnum;
+Enum< Dso::MathMode, Dso::MathMode::ADD_CH1_CH2, Dso::MathMode::BODE_CH1_CH2 > MathModeEnum;
 Enum< Dso::WindowFunction, Dso::WindowFunction::RECTANGULAR, Dso::WindowFunction::FLATTOP > WindowFunctionEnum;
 
 /// \brief Return string representation of the given math mode.
@@ -27,10 +27,47 @@ QString mathModeString( MathMode mode ) {
         return QCoreApplication::tr( "CH1 AC" );
     case MathMode::AC_CH2:
         return QCoreApplication::tr( "CH2 AC" );
+    case MathMode::ENVELOPE_CH1:
+        return QCoreApplication::tr( "CH1 Env" );
+    case MathMode::ENVELOPE_CH2:
+        return QCoreApplication::tr( "CH2 Env" );
+    case MathMode::PHASE_CH1:
+        return QCoreApplication::tr( "CH1 Phase" );
+    case MathMode::PHASE_CH2:
+        return QCoreApplication::tr( "CH2 Phase" );
+    case MathMode::FREQUENCY_CH1:
+        return QCoreApplication::tr( "CH1 Freq" );
+    case MathMode::FREQUENCY_CH2:
+        return QCoreApplication::tr( "CH2 Freq" );
+    case MathMode::BODE_CH1_CH2:
+        return QCoreApplication::tr( "Bode" );
     }
     return QString();
 }
 
+/// \brief Return the unit of the math channel values if it is not the voltage (or sensor) unit.
+/// \param mode The ::MathMode of the math channel.
+/// \return "rad" for the phase, "Hz" for the frequency demodulation, else an empty string.
+QString mathModeUnit( MathMode mode ) {
+    switch ( mode ) {
+    case MathMode::PHASE_CH1:
+    case MathMode::PHASE_CH2:
+        return QString( "rad" );
+    case MathMode::FREQUENCY_CH1:
+    case MathMode::FREQUENCY_CH2:
+        return QString( "Hz" );
+    default:
+        return QString();
+    }
+}
+
+/// \brief Return the unit per volt of the math channel trace, the trace uses the voltage gain steps.
+/// \param mode The ::MathMode of the math channel.
+/// \return 1e4 for the frequency demodulation (200 Hz/div .. 50 kHz/div), else 1.
+double mathModeScale( MathMode mode ) {
+    return mode == MathMode::FREQUENCY_CH1 || mode == MathMode::FREQUENCY_CH2 ? 1e4 : 1.0;
+}
+
 #if 0
 /// \brief Return string representation of the given dft window function.
 /// \param window The ::WindowFunction that should be returned as string.
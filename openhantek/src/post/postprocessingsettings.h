@@ -8,8 +8,24 @@ namespace Dso {
 
 /// \enum MathMode
 /// \brief The different math modes for the math-channel.
-enum class MathMode : unsigned { ADD_CH1_CH2, SUB_CH2_FROM_CH1, SUB_CH1_FROM_CH2, MUL_CH1_CH2, AC_CH1, AC_CH2 };
-extern Enum< Dso::MathMode, Dso::MathMode::ADD_CH1_CH2, Dso::MathMode::AC_CH2 > MathModeEnum;
+/// The modes starting with AC_CH1 are unary, ENVELOPE .. FREQUENCY are calculated from the analytic signal,
+/// BODE estimates the transfer function CH1 (input) -> CH2 (output).
+enum class MathMode : unsigned {
+    ADD_CH1_CH2,
+    SUB_CH2_FROM_CH1,
+    SUB_CH1_FROM_CH2,
+    MUL_CH1_CH2,
+    AC_CH1,
+    AC_CH2,
+    ENVELOPE_CH1,  ///< AM demodulation, magnitude of the analytic signal (V)
+    ENVELOPE_CH2,  ///< AM demodulation, magnitude of the analytic signal (V)
+    PHASE_CH1,     ///< Instantaneous phase of the analytic signal (rad)
+    PHASE_CH2,     ///< Instantaneous phase of the analytic signal (rad)
+    FREQUENCY_CH1, ///< FM demodulation, deviation from the mean instantaneous frequency (Hz)
+    FREQUENCY_CH2, ///< FM demodulation, deviation from the mean instantaneous frequency (Hz)
+    BODE_CH1_CH2   ///< Transfer function H(f) = CH2 / CH1, trace: CH2, spectrum: |H(f)| (dB)
+};
+extern Enum< Dso::MathMode, Dso::MathMode::ADD_CH1_CH2, Dso::MathMode::BODE_CH1_CH2 > MathModeEnum;
 
 template < class T > inline MathMode getMathMode( T &t ) { return MathMode( t.couplingOrMathIndex ); }
 
@@ -37,6 +53,8 @@ enum class WindowFunction : int {
 extern Enum< Dso::WindowFunction, Dso::WindowFunction::RECTANGULAR, Dso::WindowFunction::FLATTOP > WindowFunctionEnum;
 
 QString mathModeString( MathMode mode );
+QString mathModeUnit( MathMode mode );
+double mathModeScale( MathMode mode );
 // QString windowFunctionString(WindowFunction window);
 } // namespace Dso
 
@@ -5,7 +5,9 @@
 #include <QReadWriteLock>
 #include <QVector3D>
 
+#include "hantekdso/adccodec.h"
 #include "hantekprotocol/types.h"
+#include <cstdint>
 #include <vector>
 
 /// \brief Struct for a array of sample values.
@@ -18,7 +20,9 @@ struct SampleValues {
 struct DataChannel {
     SampleValues voltage;     ///< The time-domain voltage levels (V)
     SampleValues spectrum;    ///< The frequency-domain power levels (dB)
+    SampleValues record;      ///< ROI mode: the whole record for the spectrum, empty = use voltage
     bool valid = true;        ///< Not clipped, distorted, dropouts etc.
+    double inputPeak = -1.0;  ///< Autorange: peak input voltage (V, before the sensor function), -1 = not measured
     double vpp = 0.0;         ///< The peak-to-peak voltage of the _displayed_ part of trace
     double rms = 0.0;         ///< The DC + AC rms value of the signal = sqrt( dc * dc + acc * ac )
     double dc = 0.0;          ///< The DC bias of the signal
@@ -30,6 +34,18 @@ struct DataChannel {
     double pulseWidth2 = 0.0; ///< The width of the following pulse
 };
 
+/// \brief Bode mode: transfer function estimate CH1 (input) -> CH2 (output), the magnitude |H(f)| in dB
+/// replaces the spectrum of the math channel, phase and coherence use the same frequency bins.
+struct FrequencyResponse {
+    std::vector< double > phase;     ///< The phase of H(f) in degrees
+    std::vector< double > coherence; ///< The magnitude squared coherence 0..1, ~1 = linear response without noise
+    double interval = 0.0;           ///< The frequency step between two bins
+    unsigned averages = 0;           ///< Number of averaged segments, 0 = not calculated
+    double gain = 0.0;               ///< |H| in dB at the frequency of CH1
+    double phaseShift = 0.0;         ///< arg(H) in degrees at the frequency of CH1
+    double coherenceValue = 0.0;     ///< coherence at the frequency of CH1
+};
+
 typedef std::vector< QVector3D > ChannelGraph;
 typedef std::vector< ChannelGraph > ChannelsGraphs;
 
@@ -55,6 +71,18 @@ class PPresult {
     double pulseWidth1 = 0.0;       ///< The width of the triggered pulse
     double pulseWidth2 = 0.0;       ///< The width of the following pulse
     unsigned tag;                   ///< track individual sample blocks (debug support)
+    int64_t rollTotal = -1;         ///< roll mode: stream count after the last sample, -1 = not rolling
+    bool detail = false;            ///< dual timebase: detail frame for the zoomed scope
+    bool hasDetail = false;         ///< dual timebase: detail frames are interleaved with the overview
+    bool spectrumOnly = false;      ///< spectrum acquisition: record for span and RBW, no time domain graphs
+    int64_t requestTime = 0;        ///< ns, monotonic, the USB transfer of this frame was requested
+    int64_t completionTime = 0;     ///< ns, monotonic, the USB transfer was completed (end of the samples)
+    double deadTime = 0.0;          ///< s, gap without samples between the previous frame and this frame
+    double dutyCycle = 1.0;         ///< smoothed ratio of observed time to total time
+    unsigned roiFirst = 0;          ///< ROI mode: index of voltage.sample[ 0 ] in the whole record
+    unsigned roiCount = 0;          ///< ROI mode: number of samples of the ROI, 0 = whole record
+    RawFrame rawFrame;              ///< raw recording: compressed ADC samples, empty if not requested
+    FrequencyResponse bode;         ///< Bode mode: transfer function CH1 -> CH2, empty if not calculated
 
     ChannelsGraphs vaChannelSpectrum;
     ChannelsGraphs vaChannelVoltage;
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <algorithm>
+#include <cmath>
+
+#include "post/postprocessingsettings.h"
+#include "rollmeasurement.h"
+#include "scopesettings.h"
+
+// limit the memory of a window, roll mode is used only for slow samplerates (< 10 kS/s)
+static const size_t ROLL_WINDOW_MAX = 1000000;
+
+
+void SlidingWindow::reset( size_t newLength ) {
+    length = newLength;
+    position = 0;
+    values.clear();
+    sum = 0.0;
+    sumSquares = 0.0;
+    sinceUpdate = 0;
+    minima.clear();
+    maxima.clear();
+    edges.clear();
+    high = false;
+    total = -1;
+}
+
+
+void SlidingWindow::add( double value ) {
+    values.push_back( value );
+    sum += value;
+    sumSquares += value * value;
+    while ( !minima.empty() && minima.back().second >= value ) // these can never become the minimum again
+        minima.pop_back();
+    minima.emplace_back( position, value );
+    while ( !maxima.empty() && maxima.back().second <= value )
+        maxima.pop_back();
+    maxima.emplace_back( position, value );
+    if ( values.size() > length ) { // the oldest sample leaves the window
+        const double old = values.front();
+        values.pop_front();
+        sum -= old;
+        sumSquares -= old * old;
+    }
+    const int64_t first = position + 1 - int64_t( values.size() ); // stream position of values.front()
+    if ( minima.front().first < first )
+        minima.pop_front();
+    if ( maxima.front().first < first )
+        maxima.pop_front();
+    while ( !edges.empty() && edges.front() < first )
+        edges.pop_front();
+    // rising edge with hysteresis relative to the current window range
+    const double low = min() + ( max() - min() ) / 4;
+    const double upper = max() - ( max() - min() ) / 4;
+    if ( high && value < low ) {
+        high = false;
+    } else if ( !high && value > upper ) {
+        high = true;
+        edges.push_back( position );
+    }
+    ++position;
+    if ( ++sinceUpdate >= length ) { // recalculate the sums once per window length, avoids the rounding drift
+        sinceUpdate = 0;
+        sum = 0.0;
+        sumSquares = 0.0;
+        for ( const double sample : values ) {
+            sum += sample;
+            sumSquares += sample * sample;
+        }
+    }
+}
+
+
+double SlidingWindow::frequency( double interval ) const {
+    if ( edges.size() < 2 || interval <= 0 )
+        return 0.0;
+    return ( edges.size() - 1 ) / ( ( edges.back() - edges.front() ) * interval );
+}
+
+
+RollMeasurement::RollMeasurement( const DsoSettingsScope *scope, const DsoSettingsPostProcessing *postprocessing )
+    : scope( scope ), postprocessing( postprocessing ) {}
+
+
+void RollMeasurement::process( PPresult *result ) {
+    const double windowTime = scope->analysis.rollWindow;
+    if ( result->rollTotal < 0 || windowTime <= 0 ) { // not rolling or whole screen selected
+        windows.clear();
+        return;
+    }
+    windows.resize( result->channelCount() );
+    for ( ChannelID channel = 0; channel < result->channelCount(); ++channel ) {
+        DataChannel *const channelData = result->modifiableData( channel );
+        const std::vector< double > &samples = channelData->voltage.sample;
+        SlidingWindow &window = windows[ channel ];
+        const double interval = channelData->voltage.interval;
+        if ( samples.empty() || interval <= 0 ) {
+            window.total = -1;
+            continue;
+        }
+        const size_t length = std::min( std::max( size_t( windowTime / interval + 0.5 ), size_t( 2 ) ), ROLL_WINDOW_MAX );
+        size_t newSamples = size_t( result->rollTotal - window.total );
+        // restart with the samples on screen if the window length or the stream has changed
+        if ( window.total < 0 || result->rollTotal < window.total || newSamples > samples.size() ||
+             window.interval != interval || window.windowLength() != length ) {
+            window.reset( length );
+            window.interval = interval;
+            newSamples = std::min( samples.size(), length );
+        }
+        for ( auto it = samples.cend() - long( newSamples ); it != samples.cend(); ++it )
+            window.add( *it );
+        window.total = result->rollTotal;
+        if ( !window.count() )
+            continue;
+        const double dc = window.mean();
+        const double meanSquare = window.meanSquare();
+        channelData->dc = dc;
+        channelData->ac = sqrt( std::max( meanSquare - dc * dc, 0.0 ) );
+        channelData->rms = sqrt( std::max( meanSquare, 0.0 ) );
+        channelData->dB = 20.0 * log10( channelData->rms ) - postprocessing->spectrumReference;
+        channelData->vpp = window.max() - window.min();
+        channelData->frequency = window.frequency( interval );
+    }
+}
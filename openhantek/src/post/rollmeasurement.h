@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "processor.h"
+
+struct DsoSettingsScope;
+struct DsoSettingsPostProcessing;
+class PPresult;
+
+/// \brief Measurements over the last `length` samples of a sample stream, updated sample by sample.
+/// Each sample enters and leaves the window once: running sums for mean and rms, monotonic deques
+/// for min and max and the stream positions of the rising edges for the frequency, i.e. the cost
+/// per sample is O(1) independent of the window length.
+class SlidingWindow {
+  public:
+    void reset( size_t newLength );
+    void add( double value );
+    size_t count() const { return values.size(); }
+    size_t windowLength() const { return length; }
+    double mean() const { return sum / values.size(); }
+    double meanSquare() const { return sumSquares / values.size(); }
+    double min() const { return minima.front().second; }
+    double max() const { return maxima.front().second; }
+    /// \brief Frequency from the rising edges inside the window, 0 = less than two edges.
+    double frequency( double interval ) const;
+
+    int64_t total = -1;    ///< rollTotal of the last added sample, -1 = empty
+    double interval = 0.0; ///< time between two samples
+
+  private:
+    size_t length = 0;                                    ///< window length in samples
+    int64_t position = 0;                                 ///< stream position of the next sample
+    std::deque< double > values;                          ///< the samples inside the window
+    double sum = 0.0;                                     ///< sum of the values
+    double sumSquares = 0.0;                              ///< sum of the squared values
+    size_t sinceUpdate = 0;                               ///< samples since the sums were recalculated
+    std::deque< std::pair< int64_t, double > > minima;    ///< increasing values, front = minimum of the window
+    std::deque< std::pair< int64_t, double > > maxima;    ///< decreasing values, front = maximum of the window
+    std::deque< int64_t > edges;                          ///< stream positions of the rising edges
+    bool high = false;                                    ///< signal state (hysteresis at 25% and 75% of vpp)
+};
+
+
+/// \brief Roll mode: replace the measurements of the whole screen with sliding window measurements.
+/// Only the samples that arrived since the previous frame (see PPresult::rollTotal) are added,
+/// the window length (scope->analysis.rollWindow) is independent of the screen.
+class RollMeasurement : public Processor {
+
+  public:
+    RollMeasurement( const DsoSettingsScope *scope, const DsoSettingsPostProcessing *postprocessing );
+    void process( PPresult * ) override;
+
+  private:
+    const DsoSettingsScope *scope;
+    const DsoSettingsPostProcessing *postprocessing;
+    std::vector< SlidingWindow > windows; ///< one window for each channel
+};
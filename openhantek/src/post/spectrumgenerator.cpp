@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: GPL-2.0+
 
+#include <climits>
 #include <cmath>
 
 #include <QColor>
@@ -14,14 +15,174 @@
 #include "utils/printutils.h"
 #include "viewconstants.h"
 
+// Display-only spectra of large records are calculated with single precision (if libfftw3f is available),
+// the 8 bit ADC values need much less than the 24 bit mantissa of a float.
+// Smaller records (fast anyway) and THD calculation keep double precision.
+#ifdef HAVE_FFTW_SINGLE
+static const unsigned FFT_SINGLE_PRECISION_MIN = 1 << 16;
+#else
+static const unsigned FFT_SINGLE_PRECISION_MIN = UINT_MAX;
+#endif
+// Use all cores for large records, the thread overhead is too high for small ones.
+static const unsigned FFT_THREADS_MIN = 1 << 18;
+
+
 /// \brief Analyzes the data from the dso.
 SpectrumGenerator::SpectrumGenerator( const DsoSettingsScope *scope, const DsoSettingsPostProcessing *postprocessing )
-    : scope( scope ), postprocessing( postprocessing ) {}
+    : scope( scope ), postprocessing( postprocessing ) {
+#ifdef HAVE_FFTW_THREADS
+    fftw_init_threads();
+#ifdef HAVE_FFTW_SINGLE
+    fftwf_init_threads();
+#endif
+#endif
+}
 
 
 SpectrumGenerator::~SpectrumGenerator() {
     if ( lastWindowBuffer )
         fftw_free( lastWindowBuffer );
+    destroyPlans();
+}
+
+
+void SpectrumGenerator::destroyPlans() {
+    if ( fftForward )
+        fftw_destroy_plan( fftForward );
+    if ( fftInverse )
+        fftw_destroy_plan( fftInverse );
+    fftw_free( fftIn ); // fftw_free( nullptr ) is a no-op
+    fftw_free( fftOut );
+#ifdef HAVE_FFTW_SINGLE
+    if ( fftForwardF )
+        fftwf_destroy_plan( fftForwardF );
+    if ( fftInverseF )
+        fftwf_destroy_plan( fftInverseF );
+    fftwf_free( fftInF );
+    fftwf_free( fftOutF );
+#endif
+    fftForward = fftInverse = nullptr;
+    fftForwardF = fftInverseF = nullptr;
+    fftIn = fftOut = nullptr;
+    fftInF = fftOutF = nullptr;
+    fftLength = 0;
+}
+
+
+// (re)create the plans only if record length or precision have changed
+void SpectrumGenerator::updatePlans( unsigned sampleCount, bool singlePrecision ) {
+    if ( sampleCount == fftLength && singlePrecision == fftSinglePrecision )
+        return;
+    destroyPlans();
+    fftLength = sampleCount;
+    fftSinglePrecision = singlePrecision;
+#ifdef HAVE_FFTW_THREADS
+    const int threads = sampleCount >= FFT_THREADS_MIN ? QThread::idealThreadCount() : 1;
+#endif
+    // FFTW_ESTIMATE: planning is fast and does not touch the buffers
+    // the thread count is global planner state, reset it to 1 for the other plans (math channel, Bode)
+#ifdef HAVE_FFTW_SINGLE
+    if ( singlePrecision ) {
+#ifdef HAVE_FFTW_THREADS
+        fftwf_plan_with_nthreads( threads );
+#endif
+        fftInF = fftwf_alloc_real( sampleCount );
+        fftOutF = fftwf_alloc_real( sampleCount );
+        fftForwardF = fftwf_plan_r2r_1d( int( sampleCount ), fftInF, fftOutF, FFTW_R2HC, FFTW_ESTIMATE );
+        fftInverseF = fftwf_plan_r2r_1d( int( sampleCount ), fftInF, fftOutF, FFTW_HC2R, FFTW_ESTIMATE );
+#ifdef HAVE_FFTW_THREADS
+        fftwf_plan_with_nthreads( 1 );
+#endif
+        return;
+    }
+#endif
+#ifdef HAVE_FFTW_THREADS
+    fftw_plan_with_nthreads( threads );
+#endif
+    fftIn = fftw_alloc_real( sampleCount );
+    fftOut = fftw_alloc_real( sampleCount );
+    fftForward = fftw_plan_r2r_1d( int( sampleCount ), fftIn, fftOut, FFTW_R2HC, FFTW_ESTIMATE );
+    fftInverse = fftw_plan_r2r_1d( int( sampleCount ), fftIn, fftOut, FFTW_HC2R, FFTW_ESTIMATE );
+#ifdef HAVE_FFTW_THREADS
+    fftw_plan_with_nthreads( 1 );
+#endif
+}
+
+
+static inline void execute( fftw_plan plan ) { fftw_execute( plan ); }
+#ifdef HAVE_FFTW_SINGLE
+static inline void execute( fftwf_plan plan ) { fftwf_execute( plan ); }
+#endif
+
+
+// Transform the windowed samples in "in" to the power spectrum and calculate the autocorrelation,
+// works with double and single precision buffers and plans, see SpectrumGenerator::updatePlans().
+// Returns the position of the leftmost autocorrelation peak, i.e. the period of the signal (0 = not found).
+template < typename T, typename Plan >
+static unsigned powerSpectrumAndCorrelation( T *in, T *out, Plan forward, Plan inverse, unsigned sampleCount,
+                                             std::vector< double > &spectrum ) {
+    // Do discrete real to half-complex transformation
+    /// \todo Check if record length is multiple of 2
+    execute( forward );
+
+    // Do an autocorrelation to get the frequency of the signal
+    // fft: f(t) ⊶ F(ω); calculate power spectrum |F(ω)|²
+    // ifft: F(ω) ∙ F(ω) ⊷ f(t) ⊗ f(t) (convolution of f(t) with f(t), i.e. autocorrelation)
+    // HORO:
+    // This is quite inaccurate at high frequencies due to the used algorithm:
+    // as we do a autocorrelation the resolution at high frequencies is limited by voltagestep interval
+    // e.g. at 6 MHz sampled with 30 MS/s we get correlation at time shift
+    // of either 6 or 5 or 4 samples -> 30 MHz / 6 = 5.0 MHz ; 30 / 5 = 6.0 ; 30 / 4 = 7.5
+    // in these cases use spectrum instead if peak position is too small.
+
+    // Number of real/complex samples
+    const unsigned dftLength = sampleCount / 2;
+    const double norm = 1.0 / dftLength / dftLength;
+    // skip mirrored 2nd half of result spectrum
+    spectrum.resize( dftLength + 1 );
+
+    unsigned int position;
+    // correct the (half-)complex values in out (1st part real forward), (2nd part imag backwards) -> magnitude
+    // convert complex to magnitude square into spectrum[] and into in[] (the input of the inverse transformation)
+    spectrum[ 0 ] = double( out[ 0 ] ) * out[ 0 ]; // out[0] is only real
+    in[ 0 ] = T( spectrum[ 0 ] * norm );
+    for ( position = 1; position < dftLength; ++position ) {
+        const double re = out[ position ];
+        const double im = out[ sampleCount - position ];
+        spectrum[ position ] = re * re + im * im;
+        in[ position ] = T( spectrum[ position ] * norm );
+    }
+    spectrum[ position ] = double( out[ position ] ) * out[ position ];
+    in[ position ] = T( spectrum[ position ] * norm );
+    // Complex values, all zero for autocorrelation
+    for ( ++position; position < sampleCount; ++position ) {
+        in[ position ] = 0;
+    }
+
+    // Do half-complex to real inverse transformation -> autocorrelation
+    execute( inverse );
+    const T *correlation = out;
+
+    // Get the frequency from the correlation results
+    unsigned int peakCorrPos = 0;
+    double minCorr = 0;
+    double maxCorr = 0;
+    unsigned maxCorrPos = 0;
+    // search from right to left for a max and remember this if a following min corr (<0) is found
+    for ( position = sampleCount / 2; position > 1; --position ) { // go down to get leftmost peak (= max freq)
+        if ( correlation[ position ] > maxCorr ) {                 // find (local) max
+            maxCorr = correlation[ position ];
+            maxCorrPos = position;
+            minCorr = 0; // reset minimum to start new min search
+            // printf( "max %d: %g\n", position, maxCorr );
+        } else if ( correlation[ position ] < minCorr ) { // search for local min
+            minCorr = correlation[ position ];
+            maxCorr = 0; // reset max to start new max seach
+            peakCorrPos = maxCorrPos;
+            // printf( "min %d: %g\n", position, minCorr );
+        }
+    }
+    return peakCorrPos;
 }
 
 
@@ -37,9 +198,14 @@ void SpectrumGenerator::process( PPresult *result ) {
             channelData->spectrum.sample.clear();
             continue;
         }
+        // ROI mode: the measurements use the displayed window, the spectrum optionally the whole record
+        const std::vector< double > &fftSamples =
+            channelData->record.sample.empty() ? channelData->voltage.sample : channelData->record.sample;
+        const bool wholeRecord = &fftSamples != &channelData->voltage.sample;
+        const size_t voltageCount = channelData->voltage.sample.size();
         // Calculate new window
         // scale all windows to display 1 Veff as 0 dBu reference level.
-        size_t sampleCount = channelData->voltage.sample.size();
+        size_t sampleCount = fftSamples.size();
         if ( !lastWindowBuffer || lastWindow != postprocessing->spectrumWindow || lastRecordLength != sampleCount ) {
             if ( lastWindowBuffer )
                 fftw_free( lastWindowBuffer );
@@ -169,11 +335,9 @@ void SpectrumGenerator::process( PPresult *result ) {
         // Number of real/complex samples
         unsigned int dftLength = unsigned( sampleCount ) / 2;
 
-        // Reallocate memory for samples if the sample count has changed
-        channelData->spectrum.sample.resize( sampleCount );
-
-        // Create sample buffer and apply window
-        std::unique_ptr< double[] > windowedValues = std::unique_ptr< double[] >( new double[ sampleCount ] );
+        // Select precision and number of threads, reuse the plans if nothing has changed
+        const bool singlePrecision = !scope->analysis.calculateTHD && sampleCount >= FFT_SINGLE_PRECISION_MIN;
+        updatePlans( unsigned( sampleCount ), singlePrecision );
 
         // calculate the peak-to-peak value of the displayed part of trace
         double min = INT_MAX;
@@ -187,8 +351,8 @@ void SpectrumGenerator::process( PPresult *result ) {
         if ( left < 0 )                                                      // trig pos or time/div was increased
             left = 0;                                                        // show as much as we have on left side
         // unsigned right = result->triggerPosition + DIVS_TIME * scope->horizontal.timebase / channelData->voltage.interval;
-        if ( right >= int( sampleCount ) )
-            right = int( sampleCount ) - 1;
+        if ( right >= int( voltageCount ) )
+            right = int( voltageCount ) - 1;
         for ( int position = left; // left side of trace
               position <= right;   // right side
               ++position ) {
@@ -203,101 +367,56 @@ void SpectrumGenerator::process( PPresult *result ) {
         // calculate the average value
         double dc = 0.0;
         auto voltageIterator = channelData->voltage.sample.begin();
-        for ( unsigned int position = 0; position < sampleCount; ++position ) {
+        for ( unsigned int position = 0; position < voltageCount; ++position ) {
             dc += *voltageIterator++;
         }
-        dc /= sampleCount;
+        dc /= voltageCount;
         channelData->dc = dc;
 
         // now strip DC bias, calculate rms of AC component and apply window for fft to AC component
         double ac2 = 0.0;
         voltageIterator = channelData->voltage.sample.begin();
-        for ( unsigned int position = 0; position < sampleCount; ++position ) {
+        for ( unsigned int position = 0; position < voltageCount; ++position ) {
             double ac_sample = *voltageIterator++ - dc;
             ac2 += ac_sample * ac_sample;
-            windowedValues[ position ] = lastWindowBuffer[ position ] * ac_sample;
+            if ( wholeRecord )
+                continue;
+            if ( singlePrecision )
+                fftInF[ position ] = float( lastWindowBuffer[ position ] * ac_sample );
+            else
+                fftIn[ position ] = lastWindowBuffer[ position ] * ac_sample;
+        }
+        ac2 /= voltageCount;
+        if ( wholeRecord ) { // strip the DC bias of the whole record and apply the window
+            double recordDc = 0.0;
+            for ( const double sample : fftSamples )
+                recordDc += sample;
+            recordDc /= sampleCount;
+            for ( unsigned int position = 0; position < sampleCount; ++position ) {
+                if ( singlePrecision )
+                    fftInF[ position ] = float( lastWindowBuffer[ position ] * ( fftSamples[ position ] - recordDc ) );
+                else
+                    fftIn[ position ] = lastWindowBuffer[ position ] * ( fftSamples[ position ] - recordDc );
+            }
         }
-        ac2 /= sampleCount;
         channelData->ac = sqrt( ac2 );            // rms of AC component
         channelData->rms = sqrt( dc * dc + ac2 ); // total rms = U eff
         channelData->dB = 20.0 * log10( channelData->rms ) - postprocessing->spectrumReference;
         channelData->pulseWidth1 = result->pulseWidth1;
         channelData->pulseWidth2 = result->pulseWidth2;
 
-        // Do discrete real to half-complex transformation
-        /// \todo Check if record length is multiple of 2
-        /// \todo Reuse plan and use FFTW_MEASURE to get fastest algorithm
-
-        fftw_plan fftPlan;
-        fftPlan = fftw_plan_r2r_1d( int( sampleCount ), windowedValues.get(), &channelData->spectrum.sample.front(), FFTW_R2HC,
-                                    FFTW_ESTIMATE );
-        fftw_execute( fftPlan );
-        fftw_destroy_plan( fftPlan );
-
-        // Do an autocorrelation to get the frequency of the signal
-        // fft: f(t) ⊶ F(ω); calculate power spectrum |F(ω)|²
-        // ifft: F(ω) ∙ F(ω) ⊷ f(t) ⊗ f(t) (convolution of f(t) with f(t), i.e. autocorrelation)
-        // HORO:
-        // This is quite inaccurate at high frequencies due to the used algorithm:
-        // as we do a autocorrelation the resolution at high frequencies is limited by voltagestep interval
-        // e.g. at 6 MHz sampled with 30 MS/s we get correlation at time shift
-        // of either 6 or 5 or 4 samples -> 30 MHz / 6 = 5.0 MHz ; 30 / 5 = 6.0 ; 30 / 4 = 7.5
-        // in these cases use spectrum instead if peak position is too small.
-
-        // create a copy of powerSpectrum because hc2r iDFT destroys spectrum input
-        const double norm = 1.0 / dftLength / dftLength;
-        std::unique_ptr< double[] > powerSpectrum = std::move( windowedValues );
-
-        unsigned int position;
-        // correct the (half-)complex values in spectrum (1st part real forward), (2nd part imag backwards) -> magnitude
-        auto fwd = channelData->spectrum.sample.begin();  // forward iterator
-        auto rev = channelData->spectrum.sample.rbegin(); // reverse iterator
-        // convert complex to magnitude square in place (*fwd) and into copy (powerSpectrum[])
-        *fwd = *fwd * *fwd;
-        powerSpectrum[ 0 ] = *fwd * norm;
-        ++fwd; // spectrum[0] is only real
-        for ( position = 1; position < dftLength; ++position ) {
-            *fwd = ( *fwd * *fwd + *rev * *rev );
-            powerSpectrum[ position ] = *fwd * norm;
-            ++fwd;
-            ++rev;
-        }
-        *fwd = *fwd * *fwd;
-        powerSpectrum[ position ] = *fwd * norm;
-        ++fwd;
-        // Complex values, all zero for autocorrelation
-        for ( ++position; position < sampleCount; ++position ) {
-            powerSpectrum[ position ] = 0;
-        }
-        // skip mirrored 2nd half of result spectrum
-        channelData->spectrum.sample.resize( dftLength + 1 );
-
-        // Do half-complex to real inverse transformation -> autocorrelation
-        std::unique_ptr< double[] > correlation = std::unique_ptr< double[] >( new double[ sampleCount ] );
-        fftPlan = fftw_plan_r2r_1d( int( sampleCount ), powerSpectrum.get(), correlation.get(), FFTW_HC2R, FFTW_ESTIMATE );
-        fftw_execute( fftPlan );
-        fftw_destroy_plan( fftPlan );
-
-        // Get the frequency from the correlation results
-        unsigned int peakCorrPos = 0;
-        double minCorr = 0;
-        double maxCorr = 0;
-        unsigned maxCorrPos = 0;
-        // search from right to left for a max and remember this if a following min corr (<0) is found
-        for ( position = unsigned( sampleCount ) / 2; position > 1; --position ) { // go down to get leftmost peak (= max freq)
-            if ( correlation[ position ] > maxCorr ) {                             // find (local) max
-                maxCorr = correlation[ position ];
-                maxCorrPos = position;
-                minCorr = 0; // reset minimum to start new min search
-                // printf( "max %d: %g\n", position, maxCorr );
-            } else if ( correlation[ position ] < minCorr ) { // search for local min
-                minCorr = correlation[ position ];
-                maxCorr = 0; // reset max to start new max seach
-                peakCorrPos = maxCorrPos;
-                // printf( "min %d: %g\n", position, minCorr );
-            }
-        }
-        correlation.reset( nullptr );
+        // Calculate power spectrum and autocorrelation
+#ifdef HAVE_FFTW_SINGLE
+        const unsigned int peakCorrPos =
+            singlePrecision
+                ? powerSpectrumAndCorrelation( fftInF, fftOutF, fftForwardF, fftInverseF, unsigned( sampleCount ),
+                                               channelData->spectrum.sample )
+                : powerSpectrumAndCorrelation( fftIn, fftOut, fftForward, fftInverse, unsigned( sampleCount ),
+                                               channelData->spectrum.sample );
+#else
+        const unsigned int peakCorrPos = powerSpectrumAndCorrelation( fftIn, fftOut, fftForward, fftInverse,
+                                                                      unsigned( sampleCount ), channelData->spectrum.sample );
+#endif
 
         // Finally calculate the real spectrum (it's also used for frequency display)
         // Convert values into dB (Relative to the reference level 0 dBV = 1V eff)
@@ -305,7 +424,7 @@ void SpectrumGenerator::process( PPresult *result ) {
         double offsetLimit = postprocessing->spectrumLimit - postprocessing->spectrumReference;
         double peakSpectrum = offsetLimit; // get a start value for peak search
         unsigned int peakFreqPos = 0;      // initial position of max spectrum peak
-        position = 0;
+        unsigned int position = 0;
         for ( auto spectrumIterator = channelData->spectrum.sample.begin(), spectrumEnd = channelData->spectrum.sample.end();
               spectrumIterator != spectrumEnd; ++spectrumIterator, ++position ) {
             // spectrum is power spectrum, but show amplitude spectrum -> 10 * log...
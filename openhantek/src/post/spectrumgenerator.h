@@ -6,6 +6,7 @@
 
 #include <QMutex>
 #include <QThread>
+#include <fftw3.h>
 #include <memory>
 
 #include "dsosamples.h"
@@ -33,6 +34,21 @@ class SpectrumGenerator : public Processor {
     unsigned int lastRecordLength = 0;                          ///< The record length of the previously analyzed data
     Dso::WindowFunction lastWindow = Dso::WindowFunction( -1 ); ///< The previously used dft window function
     double *lastWindowBuffer = nullptr;
+    // FFT plans and buffers are reused as long as the record length and the precision do not change
+    // the forward plan transforms fftIn -> fftOut, the inverse plan transforms the power spectrum back
+    // fftIn -> fftOut for the autocorrelation; only the buffers of the selected precision are allocated
+    unsigned fftLength = 0;
+    bool fftSinglePrecision = false;
+    double *fftIn = nullptr;
+    double *fftOut = nullptr;
+    fftw_plan fftForward = nullptr;
+    fftw_plan fftInverse = nullptr;
+    float *fftInF = nullptr;
+    float *fftOutF = nullptr;
+    fftwf_plan fftForwardF = nullptr;
+    fftwf_plan fftInverseF = nullptr;
+    void updatePlans( unsigned sampleCount, bool singlePrecision );
+    void destroyPlans();
     // Processor interface
     void process( PPresult *data ) override;
 };
@@ -8,6 +8,7 @@
 #include "hantekdso/controlspecification.h"
 #include "hantekdso/enums.h"
 #include "hantekprotocol/definitions.h"
+#include "utils/transferfunction.h"
 #include "viewconstants.h"
 #include <vector>
 
@@ -34,18 +35,29 @@ struct DsoSettingsScopeHorizontal {
     // other PC: Not more often than every 1 ms
     double acquireInterval = 0.001; ///< Minimal time between captured frames
 #endif
-    double samplerate = 1e6; ///< The samplerate of the oscilloscope in S
-    double calfreq = 1e3;    ///< The frequency of the calibration output
+    double samplerate = 1e6;          ///< The samplerate of the oscilloscope in S
+    double calfreq = 1e3;             ///< The frequency of the calibration output
+    bool samplerateFallback = false;  ///< Switch to a lower samplerate after repeated USB transfer errors
+    bool continuousStream = false;    ///< Keep the ADC running between frames, discard the settling samples only once
+    bool dualTimebase = false;        ///< Alternate overview and detail (zoomed window) captures
+    bool spectrumAcquisition = false; ///< Select samplerate and record length from span and RBW (spectrum only)
+    double span = 20e3;               ///< Spectrum acquisition: highest frequency of interest in Hz
+    double rbw = 10;                  ///< Spectrum acquisition: resolution bandwidth (frequency bin width) in Hz
+    bool roi = false;                 ///< Process only the displayed window plus margins (region of interest)
+    bool roiSpectrum = true;          ///< ROI mode: the spectrum covers also only the ROI, else the whole record
 };
 
 /// \brief Holds the settings for the trigger.
 /// TODO Use ControlSettingsTrigger
 struct DsoSettingsScopeTrigger {
-    Dso::TriggerMode mode = Dso::TriggerMode::AUTO; ///< Automatic, normal or single trigger
-    double offset = 0.5;                            ///< Horizontal position for pretrigger (middle of screen)
-    Dso::Slope slope = Dso::Slope::Positive;        ///< Rising or falling edge causes trigger
-    int source = 0;                                 ///< Channel that is used as trigger source
-    int smooth = 0;                                 ///< Don't trigger on glitches
+    Dso::TriggerMode mode = Dso::TriggerMode::AUTO;                ///< Automatic, normal or single trigger
+    double offset = 0.5;                                           ///< Horizontal position for pretrigger (middle of screen)
+    Dso::Slope slope = Dso::Slope::Positive;                       ///< Rising or falling edge causes trigger
+    int source = 0;                                                ///< Channel that is used as trigger source
+    int smooth = 0;                                                ///< Don't trigger on glitches
+    Dso::SerialProtocol serialProtocol = Dso::SerialProtocol::OFF; ///< Trigger on decoded serial data instead of a slope
+    QString serialPattern;                                         ///< The byte pattern for the serial trigger
+    unsigned baudrate = 9600;                                      ///< The UART bit rate
 };
 
 /// \brief Base for DsoSettingsScopeSpectrum and DsoSettingsScopeVoltage
@@ -63,8 +75,9 @@ struct DsoSettingsScopeSpectrum : public DsoSettingsScopeChannel {
 
 /// \brief Holds the settings for the power analysis.
 struct DsoSettingsScopeAnalysis {
-    unsigned dummyLoad = 0; ///< Dummy load in  Ohms
+    unsigned dummyLoad = 0;    ///< Dummy load in  Ohms
     bool calculateTHD = false;
+    double rollWindow = 0.0;   ///< Roll mode: sliding window for the measurements in s, 0 = whole screen
 };
 
 /// \brief Holds the settings for the normal voltage graphs.
@@ -76,6 +89,8 @@ struct DsoSettingsScopeVoltage : public DsoSettingsScopeChannel {
     unsigned couplingOrMathIndex = 0; ///< Different index: coupling for real- and mode for math-channels
     bool inverted = false;            ///< true if the channel is inverted (mirrored on cross-axis)
     double probeAttn = 1.0;           ///< attenuation of probe
+    TransferFunction sensor;          ///< Sensor transfer function V -> sensor unit (identity = no sensor)
+    bool autoRange = false;           ///< Adapt the gain automatically to the signal level
 };
 
 /// \brief Holds the settings for the oscilloscope.
@@ -91,7 +106,14 @@ struct DsoSettingsScope {
     bool hasACcoupling = false;
     bool hasACmodification = false;
 
-    double gain( unsigned channel ) const { return gainSteps[ voltage[ channel ].gainStepIndex ] * voltage[ channel ].probeAttn; }
+    /// \brief The input voltage per screen div (V/div), this selects the hardware gain.
+    double voltageGain( unsigned channel ) const {
+        return gainSteps[ voltage[ channel ].gainStepIndex ] * voltage[ channel ].probeAttn;
+    }
+    /// \brief The displayed value per screen div, i.e. V/div or sensor unit/div (average slope over the screen height).
+    double gain( unsigned channel ) const {
+        return voltageGain( channel ) * voltage[ channel ].sensor.slope( voltageGain( channel ) * DIVS_VOLTAGE / 2 );
+    }
 
     bool anyUsed( ChannelID channel ) { return voltage[ channel ].used | spectrum[ channel ].used; }
 
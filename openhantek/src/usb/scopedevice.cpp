@@ -2,6 +2,7 @@
 
 #include <QCoreApplication>
 #include <QList>
+#include <cstring>
 #include <iostream>
 
 #include "scopedevice.h"
@@ -62,9 +63,38 @@ ScopeDevice::ScopeDevice( DSOModel *model, libusb_device *device, unsigned findI
 ScopeDevice::ScopeDevice() : model( new ModelDEMO ), device( nullptr ), uniqueUSBdeviceID( 0 ), realHW( false ) {}
 
 
+// the simulated firmware speaks the protocol of the 6022 models, it gets the request codes from here
+static SimulatedRequests simulatedRequests() {
+    using Hantek::ControlCode;
+    SimulatedRequests requests;
+    requests.getEeprom = uint8_t( ControlCode::CONTROL_GETEEPROM );
+    requests.setGain[ 0 ] = uint8_t( ControlCode::CONTROL_SETGAIN_CH1 );
+    requests.setGain[ 1 ] = uint8_t( ControlCode::CONTROL_SETGAIN_CH2 );
+    requests.setSamplerate = uint8_t( ControlCode::CONTROL_SETSAMPLERATE );
+    requests.startSampling = uint8_t( ControlCode::CONTROL_STARTSAMPLING );
+    requests.setNumChannels = uint8_t( ControlCode::CONTROL_SETNUMCHANNELS );
+    requests.setCalFreq = uint8_t( ControlCode::CONTROL_SETCALFREQ );
+    return requests;
+}
+
+
+ScopeDevice::ScopeDevice( DSOModel *model, const SimulationParameters &parameters )
+    : model( model ), device( nullptr ), findIteration( 0 ), uniqueUSBdeviceID( 0 ), nInterface( -1 ),
+      outPacketLength( 512 ), inPacketLength( 512 ), simulation( new SimulatedFX2( parameters, simulatedRequests() ) ),
+      serialNumber( "SIMULATION" ) {
+    // look like a connected device with loaded firmware
+    memset( &descriptor, 0, sizeof( descriptor ) );
+    descriptor.idVendor = uint16_t( model->vendorID );
+    descriptor.idProduct = uint16_t( model->productID );
+    descriptor.bcdDevice = uint16_t( model->firmwareVersion );
+}
+
+
 bool ScopeDevice::connectDevice( QString &errorMessage ) {
     if ( needsFirmware() )
         return false;
+    if ( simulation )
+        disconnected = false;
     if ( isConnected() )
         return true;
 
@@ -163,7 +193,9 @@ void ScopeDevice::disconnectFromDevice() {
 }
 
 
-bool ScopeDevice::isConnected() { return isDemoDevice() || ( !disconnected && this->handle != nullptr ); }
+bool ScopeDevice::isConnected() {
+    return isDemoDevice() || ( !disconnected && ( this->handle != nullptr || simulation ) );
+}
 
 
 bool ScopeDevice::needsFirmware() {
@@ -174,14 +206,16 @@ bool ScopeDevice::needsFirmware() {
 
 int ScopeDevice::bulkTransfer( unsigned char endpoint, const unsigned char *data, unsigned int length, int attempts,
                                unsigned int timeout ) {
-    if ( !this->handle )
+    if ( !this->handle && !simulation )
         return LIBUSB_ERROR_NO_DEVICE;
 
     int errorCode = LIBUSB_ERROR_TIMEOUT;
     int transferred = 0;
     for ( int attempt = 0; ( attempt < attempts || attempts == -1 ) && errorCode == LIBUSB_ERROR_TIMEOUT; ++attempt )
-        errorCode = libusb_bulk_transfer( this->handle, endpoint, const_cast< unsigned char * >( data ), int( length ),
-                                          &transferred, timeout );
+        errorCode = simulation ? simulation->bulkTransfer( endpoint, const_cast< unsigned char * >( data ), length, &transferred,
+                                                           timeout )
+                               : libusb_bulk_transfer( this->handle, endpoint, const_cast< unsigned char * >( data ),
+                                                       int( length ), &transferred, timeout );
 
     if ( errorCode == LIBUSB_ERROR_NO_DEVICE )
         disconnectFromDevice();
@@ -192,14 +226,13 @@ int ScopeDevice::bulkTransfer( unsigned char endpoint, const unsigned char *data
 }
 
 
-int ScopeDevice::bulkReadMulti( unsigned char *data, unsigned length, bool captureSmallBlocks, unsigned &received, int attempts ) {
-    if ( !handle || disconnected )
+int ScopeDevice::bulkReadMulti( unsigned char *data, unsigned length, unsigned packetLength, unsigned &received, int attempts ) {
+    if ( ( !handle && !simulation ) || disconnected )
         return LIBUSB_ERROR_NO_DEVICE;
     int retCode = 0;
-    // printf("USBDevice::bulkReadMulti( %d )\n", length );
-    if ( captureSmallBlocks ) {
+    // printf("USBDevice::bulkReadMulti( %d, %d )\n", length, packetLength );
+    if ( packetLength ) {
         // slow data is read in smaller chunks to enable quick screen update
-        const unsigned packetLength = 512 * 78; // 100 blocks for one screen width of 40000
         retCode = int( packetLength );
         unsigned int packet;
         received = 0;
@@ -232,8 +265,10 @@ int ScopeDevice::bulkReadMulti( unsigned char *data, unsigned length, bool captu
 
 int ScopeDevice::controlTransfer( unsigned char type, unsigned char request, unsigned char *data, unsigned int length, int value,
                                   int index, int attempts ) {
-    if ( !handle || disconnected )
+    if ( ( !handle && !simulation ) || disconnected )
         return LIBUSB_ERROR_NO_DEVICE;
+    if ( simulation )
+        return simulation->controlTransfer( type, request, data, length );
 
     int errorCode = LIBUSB_ERROR_TIMEOUT;
     // printf( "controlTransfer type %x request %x data[0] %d length %d value %d index %d attempts %d\n",
@@ -15,6 +15,7 @@
 #include <memory>
 
 #include "models/modelDEMO.h"
+#include "simulatedfx2.h"
 #include "usbdevicedefinitions.h"
 
 class DSOModel;
@@ -36,6 +37,8 @@ class ScopeDevice : public QObject {
   public:
     explicit ScopeDevice( DSOModel *model, libusb_device *device, unsigned findIteration = 0 );
     explicit ScopeDevice();
+    /// \brief Simulated device: the model is driven via the real USB protocol, see SimulatedFX2.
+    explicit ScopeDevice( DSOModel *model, const SimulationParameters &parameters );
     ScopeDevice( const ScopeDevice & ) = delete;
     ~ScopeDevice();
     bool connectDevice( QString &errorMessage );
@@ -48,6 +51,8 @@ class ScopeDevice : public QObject {
     /// \brief Distinguish between real hw or demo device
     bool isRealHW() const { return realHW; }
     bool isDemoDevice() const { return !realHW; }
+    /// \brief The real USB protocol is used, but the device is simulated
+    bool isSimulated() const { return bool( simulation ); }
 
     /// \brief Stop a long running (interruptable) bulk transfer
     void stopSampling() { stopTransfer = true; }
@@ -121,11 +126,12 @@ class ScopeDevice : public QObject {
     /// \brief Multi packet bulk read from the oscilloscope.
     /// \param data Buffer for the sent/received data.
     /// \param length The length of data contained in the packets.
-    /// \param captureSmallBlocks Capture many small blocks instread of one big block (faster gui update)
+    /// \param packetLength Capture many small blocks of this size instead of one big block (faster gui update),
+    /// 0 = capture one big block
     /// \param received The amount of already captured samples
     /// \param attempts The number of attempts, that are done on timeouts.
     /// \return Number of received bytes on success, libusb error code on error.
-    int bulkReadMulti( unsigned char *data, unsigned length, bool captureSmallBlocks, unsigned &received,
+    int bulkReadMulti( unsigned char *data, unsigned length, unsigned packetLength, unsigned &received,
                        int attempts = HANTEK_ATTEMPTS_MULTI );
 
     /// \brief Control transfer to the oscilloscope.
@@ -198,6 +204,7 @@ class ScopeDevice : public QObject {
     int nInterface;
     unsigned outPacketLength; ///< Packet length for the OUT endpoint
     unsigned inPacketLength;  ///< Packet length for the IN endpoint
+    std::unique_ptr< SimulatedFX2 > simulation; ///< Simulated device, replaces the libusb transfers
 
   private:
     bool realHW = true;
@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef Q_OS_FREEBSD
+#include <libusb.h>
+#else
+#include <libusb-1.0/libusb.h>
+#endif
+
+#include "simulatedfx2.h"
+
+// high speed bulk packet size
+static const unsigned PACKET_SIZE = 512;
+// one period of the simulated sine wave
+static const unsigned SINE_TABLE = 1024;
+// nominal ADC steps per volt at HW gain x1 (40 mV / digit)
+static const double DIGITS_PER_VOLT = 25.0;
+
+
+SimulatedFX2::SimulatedFX2( const SimulationParameters &parameters, const SimulatedRequests &requests )
+    : parameters( parameters ), requests( requests ) {
+    clock.start();
+    sine.resize( SINE_TABLE );
+    for ( unsigned index = 0; index < SINE_TABLE; ++index )
+        sine[ index ] = sin( 2 * M_PI * index / SINE_TABLE );
+    restartStream();
+}
+
+
+// start of sampling or new ADC settings: empty FIFO, new stream
+void SimulatedFX2::restartStream() {
+    startTime = seconds();
+    adcPosition = 0;
+    writeSequence = 0;
+    readSequence = 0;
+    segments.clear();
+    segments.emplace_back( 0, 0 );
+}
+
+
+int SimulatedFX2::controlTransfer( unsigned char type, unsigned char request, unsigned char *data, unsigned length ) {
+    QMutexLocker locker( &mutex );
+    if ( type & LIBUSB_ENDPOINT_IN ) { // read
+        if ( request == requests.getEeprom )
+            memset( data, 0xFF, length ); // empty EEPROM, i.e. no calibration values
+        return int( length );
+    }
+    if ( !length ) // all supported commands have at least one data byte
+        return int( length );
+    // coupling, firmware upload etc. are accepted without effect
+    if ( request == requests.setGain[ 0 ] ) {
+        gain[ 0 ] = std::max( data[ 0 ], uint8_t( 1 ) );
+    } else if ( request == requests.setGain[ 1 ] ) {
+        gain[ 1 ] = std::max( data[ 0 ], uint8_t( 1 ) );
+    } else if ( request == requests.setSamplerate ) { // 1, 2, ..., 48 MS/s, 1NN -> NN0 kS/s
+        const unsigned id = data[ 0 ] == 11 ? 10 : data[ 0 ];
+        samplerate = id < 100 ? id * 1e6 : ( id - 100 ) * 1e4;
+        samplerate = std::max( samplerate, 1e4 );
+        restartStream();
+    } else if ( request == requests.startSampling ) {
+        sampling = data[ 0 ] != 0;
+        restartStream();
+    } else if ( request == requests.setNumChannels ) {
+        channels = data[ 0 ] == 1 ? 1 : 2;
+        restartStream();
+    } else if ( request == requests.setCalFreq ) { // see HantekDsoControl::setCalFreq()
+        const unsigned cf = data[ 0 ];
+        calFrequency = cf == 0 ? 100 : cf <= 100 ? cf * 1e3 : cf < 200 ? ( cf - 100 ) * 10.0 : ( cf - 200 ) * 100.0;
+    }
+    return int( length );
+}
+
+
+// the ADC has written into the FIFO until "time", the bytes that do not fit into the full FIFO are lost
+void SimulatedFX2::updateFifo( double time ) {
+    uint64_t produced = uint64_t( std::max( time - startTime, 0.0 ) * samplerate * channels );
+    produced -= produced % channels; // keep the CH1/CH2 order
+    if ( produced <= adcPosition )
+        return;
+    const uint64_t newBytes = produced - adcPosition;
+    uint64_t space = parameters.fifoSize - ( writeSequence - readSequence );
+    space -= space % channels;
+    if ( newBytes > space ) {
+        writeSequence += space;
+        segments.emplace_back( writeSequence, produced ); // the next written byte continues after the gap
+        droppedBytes += newBytes - space;
+        lost = true;
+    } else {
+        writeSequence += newBytes;
+    }
+    adcPosition = produced;
+}
+
+
+// take "length" bytes from the FIFO and convert the ADC stream positions to sample values
+void SimulatedFX2::fillPacket( unsigned char *packet, unsigned length ) {
+    const double step = calFrequency / samplerate; // phase increment per sample
+    const double scale[ 2 ] = {DIGITS_PER_VOLT * gain[ 0 ], DIGITS_PER_VOLT * gain[ 1 ]};
+    unsigned index = 0;
+    while ( index < length ) {
+        while ( segments.size() > 1 && segments[ 1 ].first <= readSequence )
+            segments.pop_front();
+        // contiguous ADC samples up to the next gap
+        unsigned run = length - index;
+        if ( segments.size() > 1 )
+            run = unsigned( std::min( uint64_t( run ), segments[ 1 ].first - readSequence ) );
+        uint64_t position = segments.front().second + ( readSequence - segments.front().first );
+        double phase = fmod( double( position / channels ) * step, 1.0 );
+        for ( unsigned count = 0; count < run; ++count, ++position ) {
+            const unsigned channel = unsigned( position % channels );
+            const double voltage = channel ? sine[ unsigned( phase * SINE_TABLE ) % SINE_TABLE ] : phase < 0.5 ? 2.0 : 0.0;
+            const int code = int( floor( 0x80 + 0.5 + voltage * scale[ channel ] ) ) + int( rng() % 3 ) - 1; // 1 LSB noise
+            packet[ index + count ] = uint8_t( std::min( std::max( code, 0 ), 255 ) );
+            if ( channel == channels - 1 ) { // next sample
+                phase += step;
+                if ( phase >= 1.0 )
+                    phase -= floor( phase );
+            }
+        }
+        index += run;
+        readSequence += run;
+    }
+}
+
+
+int SimulatedFX2::bulkTransfer( unsigned char endpoint, unsigned char *data, unsigned length, int *transferred,
+                                unsigned timeout ) {
+    *transferred = 0;
+    if ( !( endpoint & LIBUSB_ENDPOINT_IN ) ) { // the simulated firmware ignores the OUT endpoint
+        *transferred = int( length );
+        return LIBUSB_SUCCESS;
+    }
+    const double deadline = seconds() + timeout * 1e-3;
+    QMutexLocker locker( &mutex );
+    if ( !sampling ) { // no data, wait for the timeout
+        locker.unlock();
+        sleepUntil( clock, deadline );
+        return LIBUSB_ERROR_TIMEOUT;
+    }
+    const double byteRate = samplerate * channels;
+    double bus = seconds() + parameters.latency + parameters.jitter * std::uniform_real_distribution< double >()( rng );
+    lost = false;
+    unsigned done = 0;
+    while ( done < length ) {
+        const unsigned packet = std::min( length - done, PACKET_SIZE );
+        // the packet is sent as soon as the ADC has filled it and the bus is free
+        updateFifo( bus );
+        const uint64_t level = writeSequence - readSequence;
+        double time = bus;
+        if ( level < packet ) { // the FIFO is not full, the ADC writes without loss
+            time = startTime + double( adcPosition + ( packet - level ) + channels ) / byteRate; // margin for the rounding
+            updateFifo( time );
+        }
+        if ( time > deadline )
+            break;
+        fillPacket( data + done, packet );
+        done += packet;
+        bus = time + packet / parameters.bandwidth;
+    }
+    transferredBytes += done;
+    if ( lost )
+        ++overruns;
+    locker.unlock();
+    sleepUntil( clock, done < length ? deadline : bus ); // the transfer takes the simulated time
+    *transferred = int( done );
+    return done < length ? LIBUSB_ERROR_TIMEOUT : LIBUSB_SUCCESS;
+}
+
+
+void SimulatedFX2::sleepUntil( const QElapsedTimer &clock, double time ) {
+    const double delay = time - clock.nsecsElapsed() * 1e-9;
+    if ( delay > 0 )
+        QThread::usleep( static_cast< unsigned long >( delay * 1e6 ) );
+}
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+/// \brief Parameters of the simulated USB connection and of the FX2 FIFO.
+struct SimulationParameters {
+    double bandwidth = 40e6;     ///< USB bulk throughput in byte/s, high speed reaches typically 35 .. 42 MB/s
+    double latency = 125e-6;     ///< delay between the request of a bulk transfer and the first packet in s
+    double jitter = 0.0;         ///< additional random delay 0 .. jitter for each bulk transfer in s
+    unsigned fifoSize = 4 * 512; ///< FX2 EP6 FIFO, quad buffered 512 byte packets
+};
+
+
+/// \brief bRequest values of the vendor control commands, set by the device that knows the protocol.
+struct SimulatedRequests {
+    uint8_t getEeprom = 0;
+    uint8_t setGain[ 2 ] = {0, 0};
+    uint8_t setSamplerate = 0;
+    uint8_t startSampling = 0;
+    uint8_t setNumChannels = 0;
+    uint8_t setCalFreq = 0;
+};
+
+
+/// \brief Simulated Hantek 6022BE for development and regression tests of the capture strategies without hardware.
+///
+/// The simulated firmware answers the control commands given by `SimulatedRequests` (gain, samplerate,
+/// channels, start/stop, calibration frequency and the EEPROM read) and serves bulk reads from a modelled FIFO.
+/// The ADC fills the FIFO with `samplerate * channels` byte/s, the host empties it packet by packet with
+/// the USB bandwidth after the transfer latency. If the host does not read fast enough (too high samplerate,
+/// long pauses between the transfers) the FIFO overruns: the FIFO content is kept, the following ADC samples
+/// are lost until the host frees a packet, i.e. the stream has a gap like with the real device.
+/// The transfers take the simulated time, the calling thread is blocked accordingly.
+///
+/// The signal is the calibration output: CH1 = square wave 0 .. 2 V, CH2 = sine wave 1 V amplitude,
+/// both with the calibration frequency and 1 LSB noise, the phase follows the stream position,
+/// so dropped samples are visible as phase jumps.
+class SimulatedFX2 {
+  public:
+    SimulatedFX2( const SimulationParameters &parameters, const SimulatedRequests &requests );
+
+    /// \brief Control transfer to/from the simulated firmware.
+    /// \return Number of transferred bytes on success, libusb error code on error.
+    int controlTransfer( unsigned char type, unsigned char request, unsigned char *data, unsigned length );
+
+    /// \brief Bulk transfer, EP IN reads the FIFO.
+    /// \param transferred Number of transferred bytes, also valid in case of a timeout.
+    /// \return libusb error code.
+    int bulkTransfer( unsigned char endpoint, unsigned char *data, unsigned length, int *transferred, unsigned timeout );
+
+    /// Statistics of the stream, see the class description
+    uint64_t getTransferredBytes() const { return transferredBytes; }
+    uint64_t getDroppedBytes() const { return droppedBytes; }
+    unsigned getOverruns() const { return overruns; }
+
+  private:
+    void restartStream();
+    void updateFifo( double time );
+    void fillPacket( unsigned char *packet, unsigned length );
+    double seconds() const { return clock.nsecsElapsed() * 1e-9; }
+    static void sleepUntil( const QElapsedTimer &clock, double time );
+
+    const SimulationParameters parameters;
+    const SimulatedRequests requests;
+    QMutex mutex;                  // the capturing thread reads while the control thread may stop the sampling
+    QElapsedTimer clock;           // device time base
+    std::minstd_rand rng;          // jitter and ADC noise
+    std::vector< double > sine;    // one period of the sine wave, indexed by the phase
+    unsigned channels = 2;         // 1: CH1 only, 2: CH1 and CH2 interleaved
+    double samplerate = 1e6;       // ADC samplerate
+    unsigned gain[ 2 ] = {1, 1};   // HW gain 1, 2, 5, 10
+    double calFrequency = 1e3;     // frequency of the calibration output
+    bool sampling = false;         // ADC running
+    double startTime = 0;          // s, device time of the start of sampling
+    uint64_t adcPosition = 0;      // ADC bytes since the start of sampling
+    uint64_t writeSequence = 0;    // bytes written into the FIFO
+    uint64_t readSequence = 0;     // bytes read from the FIFO by the host
+    // FIFO byte sequence -> ADC stream position, a new segment starts after each overrun gap
+    std::deque< std::pair< uint64_t, uint64_t > > segments;
+    bool lost = false;             // ADC bytes were lost during the current transfer
+    uint64_t droppedBytes = 0;     // ADC bytes lost due to FIFO overrun
+    unsigned overruns = 0;         // bulk transfers with lost ADC bytes
+    uint64_t transferredBytes = 0; // bytes read by the host
+};
@@ -112,6 +112,31 @@ QString valueToString( double value, Unit unit, int precision ) {
     }
 }
 
+QString valueToString( double value, const QString &unit, int precision ) {
+    char format = ( precision < 0 ) ? 'g' : 'f';
+    int logarithm = int( floor( log10( fabs( value ) ) ) );
+    if ( fabs( value ) < 1e-3 )
+        return QApplication::tr( "%L1 µ%2" )
+            .arg( value / 1e-6, 0, format, ( precision <= 0 ) ? precision : qBound( 0, precision - 7 - logarithm, precision ) )
+            .arg( unit );
+    else if ( fabs( value ) < 1.0 )
+        return QApplication::tr( "%L1 m%2" )
+            .arg( value / 1e-3, 0, format, ( precision <= 0 ) ? precision : ( precision - 4 - logarithm ) )
+            .arg( unit );
+    else if ( fabs( value ) < 1e3 )
+        return QApplication::tr( "%L1 %2" )
+            .arg( value, 0, format, ( precision <= 0 ) ? precision : qMax( 0, precision - 1 - logarithm ) )
+            .arg( unit );
+    else if ( fabs( value ) < 1e6 )
+        return QApplication::tr( "%L1 k%2" )
+            .arg( value / 1e3, 0, format, ( precision <= 0 ) ? precision : qMax( 0, precision + 2 - logarithm ) )
+            .arg( unit );
+    else
+        return QApplication::tr( "%L1 M%2" )
+            .arg( value / 1e6, 0, format, ( precision <= 0 ) ? precision : qMax( 0, precision + 5 - logarithm ) )
+            .arg( unit );
+}
+
 double stringToValue( const QString &text, Unit unit, bool *ok ) {
     // Check if the text is empty
     int totalSize = text.size();
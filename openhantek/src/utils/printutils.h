@@ -19,6 +19,13 @@ enum Unit { UNIT_VOLTS, UNIT_DECIBEL, UNIT_SECONDS, UNIT_HERTZ, UNIT_SAMPLES, UN
 /// \return String with the value and unit.
 QString valueToString( double value, Unit unit, int precision = -1 );
 
+/// \brief Converts double to string containing value and prefix + any unit, e.g. the unit of a sensor.
+/// \param value The value in prefixless units.
+/// \param unit The unit text, e.g. "A", "°C" or "bar".
+/// \param precision Significant digits, 0 for integer, -1 for auto.
+/// \return String with the value and unit.
+QString valueToString( double value, const QString &unit, int precision = -1 );
+
 /// \brief Converts string containing value and (prefix+)unit to double
 /// (Counterpart to valueToString).
 /// \param text The text containing the value and its unit.
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#include <QRegularExpression>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+
+#include "transferfunction.h"
+
+
+TransferFunction::TransferFunction( const QString &definition, const QString &unit )
+    : text( definition.trimmed() ), unitText( unit.trimmed() ) {
+    if ( text.isEmpty() )
+        return;
+    const int colon = text.indexOf( ':' );
+    const QString name = text.left( colon ).trimmed().toLower();
+    const QStringList fields = text.mid( colon + 1 ).split( QRegularExpression( "[\\s,;]+" ), QString::SkipEmptyParts );
+    std::vector< double > numbers;
+    for ( const QString &field : fields ) {
+        bool ok = false;
+        numbers.push_back( field.toDouble( &ok ) ); // C locale, always with decimal point
+        if ( !ok ) {
+            valid = false;
+            return;
+        }
+    }
+    if ( colon > 0 && name == "poly" && !numbers.empty() ) {
+        type = Type::POLYNOMIAL;
+        coefficients = numbers;
+    } else if ( colon > 0 && name == "table" && numbers.size() >= 4 && numbers.size() % 2 == 0 ) {
+        for ( size_t index = 0; index < numbers.size(); index += 2 ) {
+            if ( !tableX.empty() && numbers[ index ] <= tableX.back() ) { // x must be strictly ascending
+                tableX.clear();
+                tableY.clear();
+                valid = false;
+                return;
+            }
+            tableX.push_back( numbers[ index ] );
+            tableY.push_back( numbers[ index + 1 ] );
+        }
+        type = Type::TABLE;
+    } else {
+        valid = false;
+    }
+}
+
+
+double TransferFunction::operator()( double volt ) const {
+    switch ( type ) {
+    case Type::POLYNOMIAL: {
+        double value = 0; // Horner scheme
+        for ( auto it = coefficients.rbegin(); it != coefficients.rend(); ++it )
+            value = value * volt + *it;
+        return value;
+    }
+    case Type::TABLE: {
+        // find the segment, the first and last segments are extended to +/- infinity
+        size_t upper = size_t( std::upper_bound( tableX.begin(), tableX.end(), volt ) - tableX.begin() );
+        upper = std::min( std::max( upper, size_t( 1 ) ), tableX.size() - 1 );
+        const size_t lower = upper - 1;
+        return tableY[ lower ] +
+               ( volt - tableX[ lower ] ) * ( tableY[ upper ] - tableY[ lower ] ) / ( tableX[ upper ] - tableX[ lower ] );
+    }
+    default:
+        return volt;
+    }
+}
+
+
+double TransferFunction::slope( double range ) const {
+    if ( isIdentity() || range <= 0 )
+        return 1.0;
+    const double slope = fabs( ( ( *this )( range ) - ( *this )( -range ) ) / ( 2 * range ) );
+    return slope > 0 && std::isfinite( slope ) ? slope : 1.0;
+}
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+#pragma once
+
+#include <QString>
+#include <vector>
+
+
+/// \brief User defined (nonlinear) transfer function of a sensor, e.g. thermocouple amplifier, current clamp or
+/// pressure sensor, that maps the input voltage (at the probe tip) to the physical value in `unit()`.
+///
+/// The definition is a text that starts with the type followed by the numbers (separated by space, ',' or ';'):
+/// - "" (empty): no sensor, the value is the voltage.
+/// - "poly: c0 c1 c2 ...": polynomial y = c0 + c1 * x + c2 * x² + ...
+/// - "table: x0 y0 x1 y1 ...": piecewise linear interpolation between the points (x ascending),
+///   linear extrapolation with the first or last segment outside the table.
+class TransferFunction {
+  public:
+    TransferFunction() = default;
+    /// \brief Parse the definition, an invalid definition results in the identity function.
+    /// \param definition The text as described above.
+    /// \param unit The unit of the result, e.g. "°C", "A" or "bar".
+    explicit TransferFunction( const QString &definition, const QString &unit = QString() );
+
+    /// \brief No sensor defined, the value is the voltage.
+    bool isIdentity() const { return type == Type::IDENTITY; }
+    /// \brief The definition could be parsed (an empty definition is also valid).
+    bool isValid() const { return valid; }
+    const QString &definition() const { return text; }
+    /// \brief The unit of the result, "V" for the identity function.
+    QString unit() const { return isIdentity() || unitText.isEmpty() ? QString( "V" ) : unitText; }
+    const QString &unitDefinition() const { return unitText; }
+
+    /// \brief Map the input voltage to the physical value.
+    double operator()( double volt ) const;
+
+    /// \brief The average slope (value per volt) over the input range -range .. +range,
+    /// used to scale the screen divisions; 1.0 for the identity function or a constant function.
+    double slope( double range ) const;
+
+    bool operator==( const TransferFunction &other ) const { return text == other.text && unitText == other.unitText; }
+    bool operator!=( const TransferFunction &other ) const { return !( *this == other ); }
+
+  private:
+    enum class Type { IDENTITY, POLYNOMIAL, TABLE } type = Type::IDENTITY;
+    bool valid = true;
+    QString text;
+    QString unitText;
+    std::vector< double > coefficients; ///< polynomial c0, c1, c2, ...
+    std::vector< double > tableX;       ///< table input voltages, ascending
+    std::vector< double > tableY;       ///< table values
+};
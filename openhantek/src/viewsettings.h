@@ -45,6 +45,8 @@ struct DsoSettingsView {
     bool digitalPhosphor = false;                                     ///< true slowly fades out the previous graphs
     unsigned digitalPhosphorDepth = 8;                                ///< Number of channels shown at one time
     Dso::InterpolationMode interpolation = Dso::INTERPOLATION_LINEAR; ///< Interpolation mode for the graph
+    double traceWidth = 1.0;                                          ///< Antialiased line width of the graphs in pixel
+    double spectrumPersistence = 0.0;                                 ///< Decay time of the spectrum persistence in s, 0 = off
     bool printerColorImages = true;                                   ///< Exports images with screen colors
     bool zoomImage = true;                                            ///< Export zoomed images with double height
     bool zoom = false;                                                ///< true if the magnified scope is enabled
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-2.0+
+
+// Round trip and robustness test of the raw ADC sample codec, see ../src/hantekdso/adccodec.h
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "adccodec.h"
+
+
+static int failures = 0;
+
+
+static void check( bool ok, const char *what, size_t count, unsigned channels ) {
+    if ( !ok ) {
+        printf( "FAIL: %s (count %zu, channels %u)\n", what, count, channels );
+        ++failures;
+    }
+}
+
+
+// encode and decode the samples, the result must be identical
+static void roundTrip( const std::vector< unsigned char > &samples, unsigned channels ) {
+    std::vector< unsigned char > encoded;
+    adcEncode( samples.data(), samples.size(), channels, encoded );
+    check( encoded.size() <= 5 + ( samples.size() + ADC_CODEC_BLOCK - 1 ) / ADC_CODEC_BLOCK * ( 1 + ADC_CODEC_BLOCK ),
+           "worst case size", samples.size(), channels );
+    std::vector< unsigned char > decoded;
+    unsigned decodedChannels = 0;
+    check( adcDecode( encoded.data(), encoded.size(), decoded, decodedChannels ), "decode", samples.size(), channels );
+    check( decodedChannels == channels, "channel count", samples.size(), channels );
+    check( decoded == samples, "samples", samples.size(), channels );
+    // every truncation must be detected
+    if ( !samples.empty() ) {
+        std::vector< unsigned char > truncated;
+        for ( size_t size = 0; size < encoded.size(); size += 1 + size / 4 )
+            check( !adcDecode( encoded.data(), size, truncated, decodedChannels ), "truncated input", samples.size(), channels );
+    }
+}
+
+
+int main() {
+    std::minstd_rand rng( 6022 );
+    const size_t counts[] = {0, 1, 2, 3, 63, 64, 65, 127, 128, 129, 1000, 20480};
+    for ( unsigned channels = 1; channels <= 2; ++channels ) {
+        for ( size_t count : counts ) {
+            std::vector< unsigned char > samples( count );
+            for ( unsigned char &sample : samples ) // full range noise, largest deltas
+                sample = uint8_t( rng() );
+            roundTrip( samples, channels );
+            for ( size_t index = 0; index < count; ++index ) // square wave 0x00 <-> 0xFF with +/- 1 LSB noise
+                samples[ index ] = uint8_t( ( index / 50 ) % 2 ? 0xFE + rng() % 2 : rng() % 2 );
+            roundTrip( samples, channels );
+            for ( unsigned char &sample : samples ) // constant signal, zero width blocks
+                sample = 0x80;
+            roundTrip( samples, channels );
+        }
+    }
+
+    // a corrupt header must not allocate the claimed sample count
+    const unsigned char header[] = {0xFF, 0xFF, 0xFF, 0xFF, 1};
+    std::vector< unsigned char > decoded;
+    unsigned channels = 0;
+    check( !adcDecode( header, sizeof( header ), decoded, channels ), "corrupt sample count", 0xFFFFFFFF, 1 );
+    check( decoded.capacity() < 1024, "no allocation for a corrupt sample count", 0xFFFFFFFF, 1 );
+    const unsigned char noChannels[] = {1, 0, 0, 0, 0, 0};
+    check( !adcDecode( noChannels, sizeof( noChannels ), decoded, channels ), "zero channels", 1, 0 );
+
+    if ( failures )
+        printf( "%d failures\n", failures );
+    return failures ? 1 : 0;
+}